@@ -3,7 +3,11 @@
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec4 aColor;
 
-uniform mat4 projection;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec4 viewport;
+    float time;
+};
 
 out vec4 vertexColor;
 
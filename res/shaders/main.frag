@@ -1,8 +1,9 @@
 #version 330 core
 out vec4 FragColor;
 in vec2 TexCoord;
+in vec4 VertexColor;
 uniform sampler2D tex;
 
 void main() {
-    FragColor = texture(tex, TexCoord);
+    FragColor = texture(tex, TexCoord) * VertexColor;
 }
\ No newline at end of file
@@ -1,10 +1,17 @@
 #version 330 core
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
 out vec2 TexCoord;
-uniform mat4 projection;
+out vec4 VertexColor;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec4 viewport;
+    float time;
+};
 
 void main() {
     gl_Position = projection * vec4(aPos, 0.0, 1.0);
     TexCoord = aTexCoord;
+    VertexColor = aColor;
 }
\ No newline at end of file
@@ -1,9 +1,9 @@
 #version 330 core
 out vec4 FragColor;
 in vec2 TexCoord;
+in vec4 VertexColor;
 uniform sampler2D tex;
-uniform vec4 color;
 
 void main() {
-    FragColor = texture(tex, TexCoord) * color;
+    FragColor = texture(tex, TexCoord) * VertexColor;
 }
\ No newline at end of file
@@ -1,11 +1,32 @@
 #version 330 core
+#ifdef CLEAVE_INSTANCED
+layout (location = 0) in vec2 aPos;
+layout (location = 3) in vec4 aAxes;
+layout (location = 4) in vec2 aOrigin;
+layout (location = 5) in vec4 aUVRect;
+layout (location = 6) in vec4 aTint;
+#else
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+#endif
 out vec2 TexCoord;
-uniform mat4 projection;
-uniform mat4 model;
+out vec4 VertexColor;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec4 viewport;
+    float time;
+};
 
 void main() {
-    gl_Position = projection * model * vec4(aPos, 0.0, 1.0);
+#ifdef CLEAVE_INSTANCED
+    vec2 position = aOrigin + aAxes.xy * aPos.x + aAxes.zw * aPos.y;
+    gl_Position = projection * vec4(position, 0.0, 1.0);
+    TexCoord = mix(aUVRect.xy, aUVRect.zw, aPos);
+    VertexColor = aTint;
+#else
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
     TexCoord = aTexCoord;
+    VertexColor = aColor;
+#endif
 }
\ No newline at end of file
@@ -1,11 +1,11 @@
 #version 330 core
 in vec2 TexCoord;
+in vec4 VertexColor;
 out vec4 FragColor;
 
 uniform sampler2D tex;
-uniform vec4 color;
 
 void main() {
     float alpha = texture(tex, TexCoord).r; 
-    FragColor = vec4(color.rgb, color.a * alpha);
+    FragColor = vec4(VertexColor.rgb, VertexColor.a * alpha);
 }
@@ -0,0 +1,50 @@
+#include "FrameClock.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Cleave {
+FrameClock::FrameClock(float fixedStep, uint32_t maxStepsPerFrame)
+    : m_fixedStep(fixedStep), m_maxStepsPerFrame(std::max(maxStepsPerFrame, 1u)) {}
+
+uint32_t FrameClock::BeginFrame() {
+    const Clock::time_point now = Clock::now();
+    if (!m_started) {
+        m_lastTime = now;
+        m_started = true;
+    }
+    m_deltaTime = std::chrono::duration<float>(now - m_lastTime).count();
+    m_lastTime = now;
+
+    m_accumulator += std::min(m_deltaTime, MAX_FRAME_TIME);
+    uint32_t steps = static_cast<uint32_t>(m_accumulator / m_fixedStep);
+    m_accumulator -= steps * m_fixedStep;
+    if (steps > m_maxStepsPerFrame) {
+        steps = m_maxStepsPerFrame;
+    }
+    // Guards against float drift leaving a full step behind
+    if (m_accumulator >= m_fixedStep || m_accumulator < 0.0f) {
+        m_accumulator = std::fmod(std::max(m_accumulator, 0.0f), m_fixedStep);
+    }
+    return steps;
+}
+
+void FrameClock::Reset() {
+    m_started = false;
+    m_accumulator = 0.0f;
+    m_deltaTime = 0.0f;
+}
+
+float FrameClock::GetFixedStep() const { return m_fixedStep; }
+void FrameClock::SetFixedStep(float seconds) {
+    if (seconds > 0.0f) {
+        m_fixedStep = seconds;
+    }
+}
+
+uint32_t FrameClock::GetMaxStepsPerFrame() const { return m_maxStepsPerFrame; }
+void FrameClock::SetMaxStepsPerFrame(uint32_t steps) { m_maxStepsPerFrame = std::max(steps, 1u); }
+
+float FrameClock::GetDeltaTime() const { return m_deltaTime; }
+float FrameClock::GetAlpha() const { return m_accumulator / m_fixedStep; }
+}  // namespace Cleave
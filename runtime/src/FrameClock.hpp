@@ -0,0 +1,42 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace Cleave {
+// Turns real frame times into a whole number of fixed simulation steps. Time that doesn't
+// fill a step carries over to the next frame and is exposed as the interpolation alpha.
+class FrameClock {
+public:
+    explicit FrameClock(float fixedStep = 1.0f / 60.0f, uint32_t maxStepsPerFrame = 5);
+
+    // Measures the time since the previous call and returns how many steps to simulate now
+    uint32_t BeginFrame();
+    // Forgets the accumulated time, e.g. after a long load or when simulation resumes
+    void Reset();
+
+    float GetFixedStep() const;
+    void SetFixedStep(float seconds);
+
+    // Steps beyond this are dropped instead of letting a slow frame snowball
+    uint32_t GetMaxStepsPerFrame() const;
+    void SetMaxStepsPerFrame(uint32_t steps);
+
+    // Real time of the last frame in seconds
+    float GetDeltaTime() const;
+    // How far the current time lies between the last two simulated steps, in [0, 1)
+    float GetAlpha() const;
+
+private:
+    // Longest frame fed into the accumulator, so a breakpoint doesn't count as lag
+    static constexpr float MAX_FRAME_TIME = 0.25f;
+
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point m_lastTime;
+    bool m_started = false;
+    float m_fixedStep;
+    uint32_t m_maxStepsPerFrame;
+    float m_accumulator = 0.0f;
+    float m_deltaTime = 0.0f;
+};
+}  // namespace Cleave
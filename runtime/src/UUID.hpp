@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <random>
 #include <sstream>
 
@@ -21,4 +22,16 @@ inline std::string GenerateUUID() {
     }
     return res;
 }
+
+// Random non-zero 64-bit id; unique enough that ids saved in scene files never need remapping
+inline uint64_t GenerateId64() {
+    thread_local std::random_device dev;
+    thread_local std::mt19937_64 rng((static_cast<uint64_t>(dev()) << 32) | dev());
+
+    uint64_t id;
+    do {
+        id = rng();
+    } while (id == 0);
+    return id;
+}
 } // namespace Cleave
\ No newline at end of file
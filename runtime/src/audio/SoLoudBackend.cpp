@@ -10,14 +10,15 @@ void SoLoudBackend::Shutdown() {
     m_sounds.clear();
 }
 
-bool SoLoudBackend::LoadSound(std::shared_ptr<Sound> sound) {
+bool SoLoudBackend::LoadSound(std::shared_ptr<Sound> sound, std::span<const uint8_t> data) {
     // Check if already loaded
     if (sound->GetData() != nullptr) {
         return true;
     }
     
+    // Wav decodes everything up front, so it can read straight from the caller's bytes
     auto* wav = new SoLoud::Wav();
-    if (wav->load(sound->GetPath().c_str()) != 0) {
+    if (wav->loadMem(data.data(), static_cast<unsigned int>(data.size()), false, false) != 0) {
         delete wav;
         return false;
     }
@@ -27,10 +28,6 @@ bool SoLoudBackend::LoadSound(std::shared_ptr<Sound> sound) {
 }
 
 SoundHandle SoLoudBackend::PlaySound(std::shared_ptr<Sound> sound, float volume) {
-    if (!sound->GetData()) {
-        LoadSound(sound);
-    }
-    
     if (auto* wav = static_cast<SoLoud::Wav*>(sound->GetData())) {
         return m_engine->play(*wav, volume * m_soundVolume);
     }
@@ -45,10 +42,6 @@ void SoLoudBackend::StopSound(SoundHandle handle) {
 }
 
 void SoLoudBackend::PlayMusic(std::shared_ptr<Sound> sound, float volume) {
-    if (!sound->GetData()) {
-        LoadSound(sound);
-    }
-
     if (m_musicHandle != 0) {
         m_engine->stop(m_musicHandle);
     }
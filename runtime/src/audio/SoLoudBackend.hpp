@@ -17,7 +17,7 @@ public:
     bool Init() override;
     void Shutdown() override;
     
-    bool LoadSound(std::shared_ptr<Sound> sound) override;
+    bool LoadSound(std::shared_ptr<Sound> sound, std::span<const uint8_t> data) override;
     SoundHandle PlaySound(std::shared_ptr<Sound> sound, float volume) override;
     void StopSound(SoundHandle handle) override;
 
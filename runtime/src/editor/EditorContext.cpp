@@ -9,6 +9,7 @@
 
 #include "Log.hpp"
 #include "Window.hpp"
+#include "profiling/Profiler.hpp"
 #include "rendering/Renderer.hpp"
 #include "services/ResourceManager.hpp"
 #include "resources/Shader.hpp"
@@ -50,11 +51,11 @@ void EditorContext::Run(Renderer* renderer) {
     auto lastPrintTime = std::chrono::high_resolution_clock::now();
     while (!m_window->shouldClose()) {
         auto now = std::chrono::high_resolution_clock::now();
+        CLEAVE_PROFILE_FRAME();
         m_window->pollEvents();
         auto resourceManager = GET_RESMGR();
         auto shader = resourceManager->Get<Shader>("res/shaders/main.vert");
         renderer->UseShader(shader->GetHandle());
-        renderer->SetShaderUniformMatrix4("projection", renderer->GetProjection());
         renderer->BeginFrame();
         // Clear
         {
@@ -114,7 +115,9 @@ void EditorContext::Run(Renderer* renderer) {
             LOG_INFO("Frame Time: " << frameTimeMs 
                         << " FPS:" << (frameTimeMs > 0.0f ? 1000.0f / frameTimeMs : 0.0f) 
                         << " DrawCalls:" << renderer->GetDrawCalls()
-                        << " TextureSwaps:" << renderer->GetTextureSwaps());
+                        << " TextureSwaps:" << renderer->GetTextureSwaps()
+                        << " Batches:" << renderer->GetBatches()
+                        << " SkippedStateChanges:" << renderer->GetSkippedStateChanges());
             lastPrintTime = end;
         }
         
@@ -5,6 +5,7 @@
 #include <algorithm>
 
 #include "services/ResourceManager.hpp"
+#include "services/SceneManager.hpp"
 #include "resources/Shader.hpp"
 #include "scene/JsonSceneSerializer.hpp"
 
@@ -36,7 +37,13 @@ GameView::GameView(std::shared_ptr<Scene> scene, std::shared_ptr<Properties> pro
 
 void GameView::OnUpdate() {
     if (m_playing) {
-        m_scene->Tick();
+        // Level switches started by the running game land here, between two frames
+        SceneManager* sceneManager = GET_SCENEMGR();
+        sceneManager->Update();
+        const uint32_t steps = m_clock.BeginFrame();
+        for (uint32_t i = 0; i < steps; i++) {
+            sceneManager->GetScene()->Tick(m_clock.GetFixedStep());
+        }
     }
     ImGuiIO& io = ImGui::GetIO();
     if (io.MouseWheel != 0.0f) {
@@ -64,11 +71,12 @@ void GameView::OnRender(Renderer* renderer) {
             m_playing = !m_playing;
             if (m_playing) {
                 JsonSceneSerializer::Save(scenePath, m_scene.get());
-                m_runtimeScene = std::dynamic_pointer_cast<Scene>(SceneLoader().Load(scenePath, GET_RESMGR()));
+                // The edited scene is left alone while playing, so stopping just drops the copy
+                GET_SCENEMGR()->SetScene(m_scene->Clone());
+                m_clock.Reset();
             } else {
-                m_runtimeScene.reset();
+                GET_SCENEMGR()->SetScene(nullptr);
                 m_properties->Clear();
-                m_scene = std::dynamic_pointer_cast<Scene>(SceneLoader().Load(scenePath, GET_RESMGR()));     
             }
         }
 
@@ -126,7 +134,11 @@ void GameView::OnRender(Renderer* renderer) {
         }
     }
     
-    (m_playing ? m_runtimeScene : m_scene)->Render(renderer);
+    if (m_playing) {
+        GET_SCENEMGR()->GetScene()->Render(renderer, m_clock.GetAlpha());
+    } else {
+        m_scene->Render(renderer);
+    }
     renderer->EndFrame();
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
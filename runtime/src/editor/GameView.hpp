@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "FrameClock.hpp"
 #include "rendering/Renderer.hpp"
 #include "scene/Scene.hpp"
 #include "editor/Properties.hpp"
@@ -27,7 +28,6 @@ public:
     int GetGridSize() const;
     void SetGridSize(int size);
 private:
-    std::shared_ptr<Scene> m_runtimeScene;
     std::shared_ptr<Scene> m_scene;
     std::shared_ptr<Properties> m_properties;
     uint32_t m_frameBuffer;
@@ -38,6 +38,7 @@ private:
     bool m_gridEnabled = true;
     int m_gridSize = 32;
     bool m_playing = false;
+    FrameClock m_clock;
 };
 }  // namespace Editor
 }  // namespace Cleave
\ No newline at end of file
@@ -11,7 +11,12 @@
 #include "platform/MessageBox.hpp"
 
 #include "editor/EditorContext.hpp"
+#include "scene/BinarySceneSerializer.hpp"
 #include "scene/JsonSceneSerializer.hpp"
+#include "services/Services.hpp"
+#include "services/ResourceManager.hpp"
+#include "rendering/Renderer.hpp"
+#include "profiling/Profiler.hpp"
 
 namespace Cleave {
 namespace Editor {
@@ -34,6 +39,29 @@ void MainMenuBar::OnRender() {
                 }
             }
 
+            if (ImGui::MenuItem("Export Binary Scene")) {
+                auto currentGameView = m_editor->GetCurrentGameView();
+                if (currentGameView && currentGameView->GetScene()) {
+                    const std::string& path = currentGameView->GetScene()->GetPath();
+                    if (std::filesystem::path(path).extension() == ".jscn") {
+                        const std::string binaryPath = std::filesystem::path(path).replace_extension(".bscn").generic_string();
+                        if (BinarySceneSerializer::FromJson(path, binaryPath)) {
+                            LOG_INFO("Exported scene: " << binaryPath);
+                        }
+                    }
+                }
+            }
+
+            if (ImGui::MenuItem("Import Binary Scene..")) {
+                const std::string binaryPath = FileDialog::OpenFile("Binary scene (*.bscn)\0*.bscn\0");
+                if (!binaryPath.empty()) {
+                    const std::string jsonPath = FileDialog::SaveFile("Scene (*.jscn)\0*.jscn\0");
+                    if (!jsonPath.empty() && BinarySceneSerializer::ToJson(binaryPath, jsonPath)) {
+                        LOG_INFO("Imported scene: " << jsonPath);
+                    }
+                }
+            }
+
             if (ImGui::MenuItem("Save as..")) {
                 LOG_INFO(FileDialog::SaveFile("Project file (*.json)\0*.json\0"));
             }
@@ -60,6 +88,15 @@ void MainMenuBar::OnRender() {
             if (ImGui::MenuItem("Game View", nullptr, m_editor->IsGameViewVisible())) {
                 m_editor->SetGameViewVisible(!m_editor->IsGameViewVisible());
             }
+            Renderer* renderer = GET_RESMGR()->GetRenderer();
+            if (ImGui::MenuItem("Instanced Sprites", nullptr, renderer->IsInstancingEnabled())) {
+                renderer->SetInstancingEnabled(!renderer->IsInstancingEnabled());
+            }
+#ifdef CLEAVE_PROFILING
+            if (ImGui::MenuItem("Capture Profile (120 frames)", nullptr, false, !Profiler::IsCapturing())) {
+                Profiler::RequestCapture(120, "profile.json");
+            }
+#endif
             ImGui::EndMenu();
         }
         if (ImGui::BeginMenu("Help")) {
@@ -4,6 +4,8 @@
 #include <regex>
 #include <sstream>
 #include <filesystem>
+#include <cctype>
+#include <cstdio>
 #include <functional>
 
 #include "platform/FileDialog.hpp"
@@ -15,137 +17,130 @@ namespace Editor {
 void Properties::OnRender(Scene* scene) {
     if (!scene) return;
 
-    Entity* entity = scene->GetRoot()->GetChild(m_entityId, true);
+    Entity* entity = scene->GetEntity(m_entityId);
     if (!entity) return;
 
-    EntityId id = entity->GetId();
-    auto entityProperties = entity->GetProperties();
+    entity->GetPropertyList().ForEach([&](const PropertyDescriptor& property) {
+        if (property.hidden || property.type == PropertyType::Hidden) return;
 
-    if (!entityProperties.empty()) {
+        char displayName[64];
+        const size_t length = property.name.copy(displayName, sizeof(displayName) - 1);
+        displayName[length] = '\0';
+        displayName[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(displayName[0])));
+
+        PropertyValue value = property.get(*entity);
         bool changed = false;
-        for (auto &[name, prop] : entityProperties) {
-            std::string displayName = name;
-            std::string newValue = prop.value;
-            if (!displayName.empty())
-                displayName[0] = std::toupper(displayName[0]);
-            switch (prop.type) {
-                case Entity::Property::Types::Int: {
-                    int value = std::stoi(prop.value);
-                    if (ImGui::InputInt(displayName.c_str(), &value)) {
-                        newValue = std::to_string(value);
-                        changed = true;
-                    }
-                    break;
+        switch (property.type) {
+            case PropertyType::Int:
+                if (int* typed = std::get_if<int>(&value)) {
+                    changed = ImGui::InputInt(displayName, typed);
                 }
+                break;
 
-                case Entity::Property::Types::Float: {
-                    float value = std::stof(prop.value);
-                    if (ImGui::InputFloat(displayName.c_str(), &value)) {
-                        newValue = std::to_string(value);
-                        changed = true;
-                    }
-                    break;
+            case PropertyType::Float:
+                if (float* typed = std::get_if<float>(&value)) {
+                    changed = ImGui::InputFloat(displayName, typed);
                 }
+                break;
 
-                case Entity::Property::Types::Double: {
-                    double value = std::stod(prop.value);
-                    if (ImGui::InputDouble(displayName.c_str(), &value)) {
-                        newValue = std::to_string(value);
-                        changed = true;
-                    }
-                    break;
+            case PropertyType::Double:
+                if (double* typed = std::get_if<double>(&value)) {
+                    changed = ImGui::InputDouble(displayName, typed);
                 }
+                break;
 
-                case Entity::Property::Types::Bool: {
-                    bool value = std::stoi(prop.value);
-                    if (ImGui::Checkbox(displayName.c_str(), &value)) {
-                        newValue = std::to_string(value);
-                        changed = true;
-                    }
-                    break;
+            case PropertyType::Bool:
+                if (bool* typed = std::get_if<bool>(&value)) {
+                    changed = ImGui::Checkbox(displayName, typed);
                 }
+                break;
 
-                case Entity::Property::Types::Vec2f: {
-                    Vec2f value = Vec2f::FromString(prop.value);
-                    if (ImGui::InputFloat2(displayName.c_str(), &value.x)) {
-                        newValue = value.ToString();
-                        changed = true;
-                    }
-                    break;
+            case PropertyType::Vec2f:
+                if (Vec2f* typed = std::get_if<Vec2f>(&value)) {
+                    changed = ImGui::InputFloat2(displayName, &typed->x);
+                }
+                break;
+
+            case PropertyType::FilePath: {
+                // Every path property gets its own popup
+                ImGui::PushID(displayName);
+                char buttonLabel[80];
+                std::snprintf(buttonLabel, sizeof(buttonLabel), "Pick '%s'", displayName);
+                if (ImGui::Button(buttonLabel)) {
+                    ImGui::OpenPopup("LoadPopup");
                 }
 
-                case Entity::Property::Types::Hidden:
-                    break;
-
-                case Entity::Property::Types::FilePath:
-                    if (ImGui::Button(("Pick '" + name + "'").c_str())) {
-                        ImGui::OpenPopup("LoadPopup");
-                    } 
-
-                    if (ImGui::BeginPopup("LoadPopup")) {
-                        ImGui::BeginChild("FileList", ImVec2(300, 400), true);
-                        for (const auto& entry : std::filesystem::recursive_directory_iterator("res/")) {
-                            if (entry.is_regular_file()) {
-                                std::string path = entry.path().generic_string();
-                                if (ImGui::Selectable(path.substr(4).c_str())) {
-                                    newValue = path;
-                                    changed = true;
-                                    ImGui::CloseCurrentPopup();
-                                }
-                            }
-                        }
-                        ImGui::EndChild();
-                        ImGui::EndPopup();
-                    }
-                    break;
-                    case Entity::Property::Types::EntityId: {
-                        std::vector<std::string> options;
-                        std::vector<EntityId> ids;
-
-                        std::function<void(Entity*)> gather = [&](Entity* e) {
-                            if (!e) return;
-                            ids.push_back(e->GetId());
-                            options.push_back(e->GetName());
-                            for (auto& c : e->GetChildren())
-                                gather(c.get());
-                        };
-                        gather(scene->GetRoot());
-
-                        if (!ids.empty()) {
-                            int currentIndex = 0;
-                            auto it = std::find(ids.begin(), ids.end(), prop.value);
-                            if (it != ids.end())
-                                currentIndex = static_cast<int>(std::distance(ids.begin(), it));
-
-                            std::vector<const char*> options_cstr;
-                            for (const auto& s : options)
-                                options_cstr.push_back(s.c_str());
-
-                            if (ImGui::Combo(displayName.c_str(), &currentIndex, options_cstr.data(), (int)options_cstr.size())) {
-                                newValue = ids[currentIndex];
+                if (ImGui::BeginPopup("LoadPopup")) {
+                    ImGui::BeginChild("FileList", ImVec2(300, 400), true);
+                    for (const auto& entry : std::filesystem::recursive_directory_iterator("res/")) {
+                        if (entry.is_regular_file()) {
+                            std::string path = entry.path().generic_string();
+                            if (ImGui::Selectable(path.c_str() + 4)) {
+                                value = std::move(path);
                                 changed = true;
+                                ImGui::CloseCurrentPopup();
                             }
                         }
-                        break;
                     }
-                default: {
+                    ImGui::EndChild();
+                    ImGui::EndPopup();
+                }
+                ImGui::PopID();
+                break;
+            }
+
+            case PropertyType::EntityId: {
+                const EntityId* current = std::get_if<EntityId>(&value);
+                if (!current) break;
+
+                std::vector<std::string> options;
+                std::vector<EntityId> ids;
+
+                std::function<void(Entity*)> gather = [&](Entity* e) {
+                    if (!e) return;
+                    ids.push_back(e->GetId());
+                    options.push_back(e->GetName());
+                    for (auto& c : e->GetChildren())
+                        gather(c.get());
+                };
+                gather(scene->GetRoot());
+
+                if (!ids.empty()) {
+                    int currentIndex = 0;
+                    auto it = std::find(ids.begin(), ids.end(), *current);
+                    if (it != ids.end())
+                        currentIndex = static_cast<int>(std::distance(ids.begin(), it));
+
+                    std::vector<const char*> options_cstr;
+                    for (const auto& s : options)
+                        options_cstr.push_back(s.c_str());
+
+                    if (ImGui::Combo(displayName, &currentIndex, options_cstr.data(), (int)options_cstr.size())) {
+                        value = ids[currentIndex];
+                        changed = true;
+                    }
+                }
+                break;
+            }
+
+            default:
+                if (std::string* typed = std::get_if<std::string>(&value)) {
                     char buffer[256];
-                    strncpy_s(buffer, prop.value.c_str(), sizeof(buffer));
+                    strncpy_s(buffer, typed->c_str(), sizeof(buffer));
                     buffer[sizeof(buffer) - 1] = '\0';
-                    if (ImGui::InputText(displayName.c_str(), buffer, sizeof(buffer))) {
-                        newValue = buffer;
+                    if (ImGui::InputText(displayName, buffer, sizeof(buffer))) {
+                        *typed = buffer;
                         changed = true;
                     }
                 }
-            }
-            if (changed) entity->SetProperty(name, newValue);
         }
-    }
+        if (changed) property.set(*entity, value);
+    });
 }
 
 EntityId Properties::GetEntityId() const { return m_entityId; }
 void Properties::SetEntityId(EntityId id) { m_entityId = id; }
 
-void Properties::Clear() { m_entityId = ""; }
+void Properties::Clear() { m_entityId = Entity::INVALID_ID; }
 }  // namespace Editor
 }  // namespace Cleave
\ No newline at end of file
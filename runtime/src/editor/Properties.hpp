@@ -16,7 +16,7 @@ public:
 
     void Clear();
 private:
-    EntityId m_entityId = "";
+    EntityId m_entityId = Entity::INVALID_ID;
 };
 }  // namespace Editor
 }  // namespace Cleave
\ No newline at end of file
@@ -9,49 +9,61 @@
 #include "rendering/Renderer.hpp"
 
 namespace Cleave {
-const Entity::PropertyMap AnimatedSprite::GetProperties() const {
-    auto properties = Sprite::GetProperties();
-    properties["type"] = {GetTypeName(), Property::Types::Hidden};
-    properties["playing"] = {std::to_string(IsPlaying()), Property::Types::Bool};
-    properties["frameSize"] = {m_frameSize.ToString(), Property::Types::Vec2f};
-    properties["frameCount"] = {std::to_string(m_frameCount), Property::Types::Int};
-    properties["frameDuration"] = {std::to_string(m_frameDuration), Property::Types::Float};
-    properties["loop"] = {std::to_string(m_loop), Property::Types::Bool};
-    return properties;
-}
+const PropertyDescriptor AnimatedSprite::PROPERTY_DESCRIPTORS[] = {
+    MakeProperty<AnimatedSprite>("playing", PropertyType::Bool,
+        [](const AnimatedSprite& sprite) { return sprite.GetState().playing; },
+        [](AnimatedSprite& sprite, bool playing) { sprite.GetState().playing = playing; }),
+    MakeProperty<AnimatedSprite>("frameSize", PropertyType::Vec2f,
+        [](const AnimatedSprite& sprite) {
+            const Vec2i frameSize = sprite.GetState().frameSize;
+            return Vec2f(static_cast<float>(frameSize.x), static_cast<float>(frameSize.y));
+        },
+        [](AnimatedSprite& sprite, Vec2f frameSize) {
+            sprite.GetState().frameSize = {static_cast<int>(frameSize.x), static_cast<int>(frameSize.y)};
+        }),
+    MakeProperty<AnimatedSprite>("frameCount", PropertyType::Int,
+        [](const AnimatedSprite& sprite) { return sprite.GetState().frameCount; },
+        [](AnimatedSprite& sprite, int frameCount) { sprite.GetState().frameCount = frameCount; }),
+    MakeProperty<AnimatedSprite>("frameDuration", PropertyType::Float,
+        [](const AnimatedSprite& sprite) { return sprite.GetState().frameDuration; },
+        [](AnimatedSprite& sprite, float frameDuration) { sprite.GetState().frameDuration = frameDuration; }),
+    MakeProperty<AnimatedSprite>("loop", PropertyType::Bool,
+        [](const AnimatedSprite& sprite) { return sprite.GetState().loop; },
+        [](AnimatedSprite& sprite, bool loop) { sprite.GetState().loop = loop; }),
+};
+const PropertyList AnimatedSprite::PROPERTIES = {GetTypeName(), PROPERTY_DESCRIPTORS, &Sprite::PROPERTIES};
 
-void AnimatedSprite::SetProperty(const std::string_view name, const std::string& value) {
-    if (name == "playing") {
-        m_playing = std::stoi(value);
-    } else if (name == "frameSize") {
-        m_frameSize = Vec2i::FromString(value);
-    } else if (name == "frameCount") {
-        m_frameCount = std::stoi(value); 
-    } else if (name == "frameDuration") {
-        m_frameDuration = std::stof(value);
-    } else if (name == "loop") {
-        m_loop = std::stoi(value);
-    } else {
-        Sprite::SetProperty(name, value);
-    }
-}
+const PropertyList& AnimatedSprite::GetPropertyList() const { return PROPERTIES; }
 
 Entity* AnimatedSprite::Create() { return new AnimatedSprite(); }
 
+std::unique_ptr<Entity> AnimatedSprite::CloneSelf() const {
+    auto clone = std::make_unique<AnimatedSprite>();
+    clone->SetMaterial(GetMaterial());
+    clone->SetOrigin(GetOrigin());
+    clone->m_state = GetState();
+    CopyEntityState(*clone);
+    return clone;
+}
+
 void AnimatedSprite::OnTick(float deltaTime) {
-    if (!m_playing || !GetMaterial().texture || m_frameDuration <= 0) return;
+    // Storage-backed animations are advanced by EntityStorage::TickAnimations
+    if (GetStorage()) return;
+
+    EntityStorage::AnimationState& state = GetState();
+    if (!state.playing || !GetMaterial().texture || state.frameDuration <= 0) return;
     
-    m_time += deltaTime;
+    state.time += deltaTime;
     
-    while (m_time >= m_frameDuration) {
-        m_time -= m_frameDuration;
-        m_frame++;
+    while (state.time >= state.frameDuration) {
+        state.time -= state.frameDuration;
+        state.frame++;
         
-        if (m_frame >= m_frameCount) {
-            if (m_loop) {
-                m_frame = 0;
+        if (state.frame >= state.frameCount) {
+            if (state.loop) {
+                state.frame = 0;
             } else {
-                m_frame = m_frameCount - 1;
+                state.frame = state.frameCount - 1;
                 Stop();
             }
         }
@@ -65,27 +77,16 @@ void AnimatedSprite::OnRender(Renderer* renderer) {
     float rotation = GetTransform().GetWorldRotation();
     Vec2f scale = GetTransform().GetWorldScale();
     
-    Vec2f offset = Vec2f(m_frameSize.x * 0.5f, m_frameSize.y * 0.5f);
-    
-    Transform transform;
-    transform.Translate(globalPosition);
-    transform.Translate(-offset);
-    transform.Rotate(rotation);
-    transform.Scale(scale);
-    
-    auto resourceManager = GET_RESMGR();
-    auto shader = resourceManager->Get<Shader>("res/shaders/sprite.vert");
-    if (!shader) return;
-
-    Vec2i framePos = GetFramePosition(m_frame);
+    const EntityStorage::AnimationState& state = GetState();
+    Vec2i framePos = GetFramePosition(state.frame);
 
-    float texWidth = static_cast<float>(GetMaterial().texture->GetWidth());
-    float texHeight = static_cast<float>(GetMaterial().texture->GetHeight());
+    const Texture& texture = *GetMaterial().texture;
+    float texWidth = static_cast<float>(texture.GetWidth());
+    float texHeight = static_cast<float>(texture.GetHeight());
     
-    const float u0 = framePos.x / texWidth;
-    const float v0 = framePos.y / texHeight;
-    const float u1 = (framePos.x + m_frameSize.x) / texWidth;
-    const float v1 = (framePos.y + m_frameSize.y) / texHeight;
+    // Frame UVs are relative to the image, which may sit inside an atlas page
+    const Vec2f uv0 = texture.MapUV({framePos.x / texWidth, framePos.y / texHeight});
+    const Vec2f uv1 = texture.MapUV({(framePos.x + state.frameSize.x) / texWidth, (framePos.y + state.frameSize.y) / texHeight});
     
     renderer->SetMaterial(GetMaterial());
     renderer->SetDepth(GetDepth());
@@ -93,44 +94,78 @@ void AnimatedSprite::OnRender(Renderer* renderer) {
         Rect4f {
             .x = globalPosition.x,
             .y = globalPosition.y,
-            .w = static_cast<float>(m_frameSize.x),
-            .h = static_cast<float>(m_frameSize.y),
+            .w = static_cast<float>(state.frameSize.x),
+            .h = static_cast<float>(state.frameSize.y),
         },
-        u0, v0, u1, v1, Color::White()
+        scale.x, scale.y, rotation,
+        uv0.x, uv0.y, uv1.x, uv1.y, Color::White()
     );
 }
 
-int AnimatedSprite::GetFrame() const { return m_frame; }
+bool AnimatedSprite::GetWorldBounds(Rect4f& bounds) {
+    const Transform& transform = GetTransform();
+    const Vec2i frameSize = GetState().frameSize;
+    const Vec2f size = {static_cast<float>(frameSize.x), static_cast<float>(frameSize.y)};
+    bounds = Rect4f::FromQuad(transform.GetWorldPosition(), size * transform.GetWorldScale(), transform.GetWorldRotation());
+    return true;
+}
+
+int AnimatedSprite::GetFrame() const { return GetState().frame; }
 void AnimatedSprite::SetFrame(int frame) {
-    if (frame >= 0 && frame < m_frameCount) {
-        m_frame = frame;
-        m_time = 0;
+    EntityStorage::AnimationState& state = GetState();
+    if (frame >= 0 && frame < state.frameCount) {
+        state.frame = frame;
+        state.time = 0;
     }
 }
 
-Vec2i AnimatedSprite::GetFrameSize() const { return m_frameSize; }
+Vec2i AnimatedSprite::GetFrameSize() const { return GetState().frameSize; }
 void AnimatedSprite::SetFrameSize(Vec2i size) {
     if (size.x > 0 && size.y > 0) {
-        m_frameSize = size;
+        GetState().frameSize = size;
     }
 }
 
 Vec2i AnimatedSprite::GetFramePosition(int frame) const {
-    if (frame < 0 || frame >= m_frameCount) return {0, 0};
+    const EntityStorage::AnimationState& state = GetState();
+    if (frame < 0 || frame >= state.frameCount) return {0, 0};
     
-    const int frameX = (frame % m_frameCount) * m_frameSize.x;
-    const int frameY = (frame / m_frameCount) * m_frameSize.y;
+    const int frameX = (frame % state.frameCount) * state.frameSize.x;
+    const int frameY = (frame / state.frameCount) * state.frameSize.y;
     return {frameX, frameY};
 }
 
-bool AnimatedSprite::IsPlaying() const { return m_playing; }
+bool AnimatedSprite::IsPlaying() const { return GetState().playing; }
 void AnimatedSprite::Play(float frameDuration, bool loop) {
-    m_frameDuration = frameDuration;
-    m_playing = true;
-    m_loop = loop;
+    EntityStorage::AnimationState& state = GetState();
+    state.frameDuration = frameDuration;
+    state.playing = true;
+    state.loop = loop;
 }
 
 void AnimatedSprite::Stop() {
-    m_playing = false;
+    GetState().playing = false;
+}
+
+void AnimatedSprite::OnAttachStorage() {
+    Sprite::OnAttachStorage();
+    GetStorage()->AddAnimation(GetStorageSlot(), m_state);
+}
+
+void AnimatedSprite::OnDetachStorage() {
+    m_state = GetState();
+    GetStorage()->RemoveAnimation(GetStorageSlot());
+}
+
+EntityStorage::AnimationState& AnimatedSprite::GetState() {
+    EntityStorage* storage = GetStorage();
+    EntityStorage::AnimationState* state = storage ? storage->GetAnimation(GetStorageSlot()) : nullptr;
+    return state ? *state : m_state;
+}
+
+const EntityStorage::AnimationState& AnimatedSprite::GetState() const {
+    const EntityStorage* storage = GetStorage();
+    const EntityStorage::AnimationState* state = storage ? storage->GetAnimation(GetStorageSlot()) : nullptr;
+    return state ? *state : m_state;
 }
 } // namespace Cleave
\ No newline at end of file
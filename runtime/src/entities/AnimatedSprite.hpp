@@ -1,6 +1,7 @@
 #pragma once
 
 #include "entities/Sprite.hpp"
+#include "scene/EntityStorage.hpp"
 
 namespace Cleave {
 class AnimatedSprite : public Sprite {
@@ -9,17 +10,19 @@ public:
     AnimatedSprite(Transform transform,
                    Material material,
                    Vec2i frameSize, int frameCount)
-        : Sprite(transform, material),
-          m_frameSize(frameSize),
-          m_frameCount(frameCount) {}
+        : Sprite(transform, material) {
+        m_state.frameSize = frameSize;
+        m_state.frameCount = frameCount;
+    }
 
     void OnTick(float deltaTime) override;
     void OnRender(Renderer* renderer) override;
+    bool GetWorldBounds(Rect4f& bounds) override;
 
-    static const char* GetTypeName() { return "cleave::AnimatedSprite"; }
+    static constexpr const char* GetTypeName() { return "cleave::AnimatedSprite"; }
 
-    const PropertyMap GetProperties() const override;
-    void SetProperty(const std::string_view name, const std::string& value) override;
+    static const PropertyList PROPERTIES;
+    const PropertyList& GetPropertyList() const override;
 
     static Entity* Create();
 
@@ -34,14 +37,19 @@ public:
     void SetFrameSize(Vec2i size);
 
     Vec2i GetFramePosition(int frame) const;
+
+protected:
+    std::unique_ptr<Entity> CloneSelf() const override;
+    void OnAttachStorage() override;
+    void OnDetachStorage() override;
+
 private:
-    Vec2i m_frameSize = {32, 32};
-
-    int m_frameCount = 1;
-    int m_frame = 0;
-    float m_time = 0.0f;
-    float m_frameDuration = 0.1f;
-    bool m_playing = false;
-    bool m_loop = true;
+    static const PropertyDescriptor PROPERTY_DESCRIPTORS[];
+
+    // The packed state in dense storage mode, m_state otherwise
+    EntityStorage::AnimationState& GetState();
+    const EntityStorage::AnimationState& GetState() const;
+
+    EntityStorage::AnimationState m_state;
 };
 }  // namespace Cleave
\ No newline at end of file
@@ -6,29 +6,37 @@ namespace Cleave {
 float Camera::GetZoom() const { return m_zoom; }
 void Camera::SetZoom(float zoom) { m_zoom = zoom; }
 
-const Entity::PropertyMap Camera::GetProperties() const {
-    auto properties = Entity::GetProperties();
-    properties["type"] = {GetTypeName(), Entity::Property::Types::Hidden};
-    properties["zoom"] = {std::to_string(m_zoom), Entity::Property::Types::Float};
-    return properties;
-}
-void Camera::SetProperty(const std::string_view name, const std::string& value) {
-    if (name == "zoom") {
-        m_zoom = std::stof(value);
-    } else {
-        Entity::SetProperty(name, value);
-    }
-}
+const PropertyDescriptor Camera::PROPERTY_DESCRIPTORS[] = {
+    MakeProperty<Camera>("zoom", PropertyType::Float,
+        [](const Camera& camera) { return camera.m_zoom; },
+        [](Camera& camera, float zoom) { camera.m_zoom = zoom; }),
+};
+const PropertyList Camera::PROPERTIES = {GetTypeName(), PROPERTY_DESCRIPTORS, &Entity::PROPERTIES};
+
+const PropertyList& Camera::GetPropertyList() const { return PROPERTIES; }
 
 Entity* Camera::Create() { return new Camera(); }
 
+std::unique_ptr<Entity> Camera::CloneSelf() const {
+    auto clone = std::make_unique<Camera>();
+    clone->m_zoom = m_zoom;
+    CopyEntityState(*clone);
+    return clone;
+}
+
 void Camera::OnRender(Renderer* renderer) {
+    Matrix4 projection;
+    GetProjection(renderer, projection);
+    renderer->SetProjection(projection);
+}
+
+bool Camera::GetProjection(Renderer* renderer, Matrix4& projection) {
     float aspect = renderer->GetViewPort().w / renderer->GetViewPort().h;
-    Matrix4 projection = Matrix4::Ortho(
+    projection = Matrix4::Ortho(
         -aspect * m_zoom, aspect * m_zoom,
         -m_zoom, m_zoom,
         -1.0f, 1.0f);
-    renderer->SetProjection(projection);
+    return true;
 }
 
 }  // namespace Cleave
\ No newline at end of file
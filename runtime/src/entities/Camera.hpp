@@ -10,16 +10,24 @@ public:
     float GetZoom() const;
     void SetZoom(float zoom);
 
-    static const char* GetTypeName() { return "cleave::Camera"; }
+    static constexpr const char* GetTypeName() { return "cleave::Camera"; }
 
-    const PropertyMap GetProperties() const override;
-    void SetProperty(const std::string_view name, const std::string& value) override;
+    static const PropertyList PROPERTIES;
+    const PropertyList& GetPropertyList() const override;
 
     static Entity* Create();
     
     void OnRender(Renderer* renderer) override;
-    
+    // Only sets the projection, which buckets hand back in order
+    bool IsRenderStateSelfContained() const override { return true; }
+    bool GetProjection(Renderer* renderer, Matrix4& projection) override;
+
+protected:
+    std::unique_ptr<Entity> CloneSelf() const override;
+
 private:
+    static const PropertyDescriptor PROPERTY_DESCRIPTORS[];
+
     float m_zoom = 1.0f;
 };
 }  // namespace Cleave
\ No newline at end of file
@@ -1,13 +1,28 @@
 #include "Entity.hpp"
 
+#include <charconv>
+#include <typeinfo>
+
+#include "profiling/Profiler.hpp"
+#include "Log.hpp"
+#include "scene/EntityIndex.hpp"
+#include "scene/EntityStorage.hpp"
+#include "scene/SceneLoad.hpp"
+
 namespace Cleave {
-void Entity::Init(const PropertyMap& properties) {
-    for (const auto& [name, prop] : properties) {
-        SetProperty(name, prop.value);
+Entity::~Entity() {
+    if (m_index) {
+        m_index->Remove(this);
     }
+    if (m_storage) {
+        m_storage->Release(m_slot);
+    }
+    SceneLoad::DropSteps(*this);
 }
 
 void Entity::Tick(float deltaTime) {
+    CLEAVE_PROFILE_SCOPE("Entity::Tick");
+    m_transform.SavePrevious();
     OnTick(deltaTime);
 
     for (const auto& child : m_children) {
@@ -16,6 +31,8 @@ void Entity::Tick(float deltaTime) {
 }
 
 void Entity::Render(Renderer* renderer) {
+    if (!IsVisible()) return;
+
     OnRender(renderer);
 
     for (const auto& child : m_children) {
@@ -23,41 +40,105 @@ void Entity::Render(Renderer* renderer) {
     }
 }
 
+void Entity::UpdateTransforms() {
+    m_transform.UpdateWorldTransform();
+
+    for (const auto& child : m_children) {
+        child->UpdateTransforms();
+    }
+}
+
 void Entity::OnTick(float deltaTime) {}
+void Entity::OnPreRender() {}
 void Entity::OnRender(Renderer* renderer) {}
+bool Entity::CanTickInParallel() const { return true; }
+bool Entity::IsRenderStateSelfContained() const { return typeid(*this) == typeid(Entity); }
+bool Entity::GetWorldBounds(Rect4f& bounds) { return false; }
+bool Entity::GetProjection(Renderer* renderer, Matrix4& projection) { return false; }
 
-const Entity::PropertyMap Entity::GetProperties() const {
-    PropertyMap properties;
-    properties["type"] = {GetTypeName(), Property::Types::Hidden};
-    properties["id"] = {m_id, Property::Types::Hidden};
-    properties["name"] = {m_name, Property::Types::String};
-    properties["position"] = {m_transform.GetPosition().ToString(), Property::Types::Vec2f};
-    properties["scale"] = {m_transform.GetScale().ToString(), Property::Types::Vec2f};
-    properties["rotation"] = {std::to_string(m_transform.GetRotationDegrees()), Property::Types::Float};
-    properties["depth"] = {std::to_string(m_depth), Property::Types::Int};
-    return properties;
-}
-
-void Entity::SetProperty(const std::string_view name, const std::string& value) {
-    if (name == "id") {
-        SetId(value);
-    } else if (name == "name") {
-        SetName(value);
-    } else if (name == "position") {
-        m_transform.SetPosition(Vec2f::FromString(value));
-    } else if (name == "scale") {
-        m_transform.SetScale(Vec2f::FromString(value));
-    } else if (name == "rotation") {
-        m_transform.SetRotationDegrees(std::stof(value));
-    } else if (name == "depth") {
-        SetDepth(std::stoi(value));
-    }
+const PropertyDescriptor Entity::PROPERTY_DESCRIPTORS[] = {
+    MakeProperty<Entity>("id", PropertyType::EntityId,
+        [](const Entity& entity) { return entity.m_id; },
+        [](Entity& entity, EntityId id) { entity.SetId(id); }, true),
+    MakeProperty<Entity>("name", PropertyType::String,
+        [](const Entity& entity) { return entity.m_name; },
+        [](Entity& entity, const std::string& name) { entity.SetName(name); }),
+    MakeProperty<Entity>("position", PropertyType::Vec2f,
+        [](const Entity& entity) { return entity.m_transform.GetPosition(); },
+        [](Entity& entity, Vec2f position) { entity.m_transform.SetPosition(position); }),
+    MakeProperty<Entity>("scale", PropertyType::Vec2f,
+        [](const Entity& entity) { return entity.m_transform.GetScale(); },
+        [](Entity& entity, Vec2f scale) { entity.m_transform.SetScale(scale); }),
+    MakeProperty<Entity>("rotation", PropertyType::Float,
+        [](const Entity& entity) { return entity.m_transform.GetRotationDegrees(); },
+        [](Entity& entity, float rotation) { entity.m_transform.SetRotationDegrees(rotation); }),
+    MakeProperty<Entity>("depth", PropertyType::Int,
+        [](const Entity& entity) { return entity.GetDepth(); },
+        [](Entity& entity, int depth) { entity.SetDepth(depth); }),
+};
+const PropertyList Entity::PROPERTIES = {GetTypeName(), PROPERTY_DESCRIPTORS, nullptr};
+
+const PropertyList& Entity::GetPropertyList() const { return PROPERTIES; }
+const PropertyDescriptor* Entity::FindProperty(const std::string_view name) const {
+    return GetPropertyList().Find(name);
 }
 
 Entity* Entity::Create() { return new Entity(); }
 
+std::unique_ptr<Entity> Entity::Clone() const {
+    std::unique_ptr<Entity> clone = CloneSelf();
+    clone->m_children.reserve(m_children.size());
+    for (const auto& child : m_children) {
+        clone->AddChild(child->Clone());
+    }
+    return clone;
+}
+
+std::unique_ptr<Entity> Entity::CloneSelf() const {
+    auto clone = std::make_unique<Entity>();
+    CopyEntityState(*clone);
+    return clone;
+}
+
+void Entity::CopyEntityState(Entity& clone) const {
+    clone.m_name = m_name;
+    clone.m_transform.SetPosition(m_transform.GetPosition());
+    clone.m_transform.SetScale(m_transform.GetScale());
+    clone.m_transform.SetRotation(m_transform.GetRotation());
+    clone.m_transform.SavePrevious();
+    clone.m_active = m_active;
+    clone.SetDepth(GetDepth());
+    clone.SetVisible(IsVisible());
+}
+
+EntityId Entity::ParseId(const std::string_view value) {
+    EntityId id = INVALID_ID;
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), id);
+    if (error == std::errc() && end == value.data() + value.size()) {
+        return id;
+    }
+
+    // FNV-1a, so every reference to the same legacy id resolves to the same entity
+    id = 14695981039346656037ull;
+    for (char c : value) {
+        id ^= static_cast<uint8_t>(c);
+        id *= 1099511628211ull;
+    }
+    return id;
+}
+
 EntityId Entity::GetId() const { return m_id; }
-void Entity::SetId(EntityId id) { m_id = id; }
+void Entity::SetId(EntityId id) {
+    if (id == m_id) return;
+
+    if (m_index) {
+        m_index->Remove(this);
+    }
+    m_id = id;
+    if (m_index && !m_index->Add(this)) {
+        LOG_WARN("Duplicate entity id " << m_id << ", it won't be found by id lookups");
+    }
+}
 
 const std::string& Entity::GetName() const { return m_name; }
 void Entity::SetName(const std::string& name) { m_name = name; }
@@ -74,8 +155,23 @@ void Entity::SetScale(const Vec2f& scale) { m_transform.SetScale(scale); }
 float Entity::GetRotation() { return m_transform.GetRotationDegrees(); }
 void Entity::SetRotation(const float rotation) { m_transform.SetRotationDegrees(rotation); }
 
-int Entity::GetDepth() { return m_depth; }
-void Entity::SetDepth(int depth) { m_depth = depth; }
+int Entity::GetDepth() const { return m_storage ? m_storage->GetDepth(m_slot) : m_depth; }
+void Entity::SetDepth(int depth) {
+    if (m_storage) {
+        m_storage->SetDepth(m_slot, depth);
+    } else {
+        m_depth = depth;
+    }
+}
+
+bool Entity::IsVisible() const { return m_storage ? m_storage->IsVisible(m_slot) : m_visible; }
+void Entity::SetVisible(bool visible) {
+    if (m_storage) {
+        m_storage->SetVisible(m_slot, visible);
+    } else {
+        m_visible = visible;
+    }
+}
 
 Entity* Entity::GetParent() const { return m_parent; }
 void Entity::SetParent(Entity* parent) {
@@ -100,10 +196,15 @@ void Entity::AddChild(std::unique_ptr<Entity> child) {
     }
 
     child->SetParent(this);
+    child->AttachStorage(m_storage);
+    child->AttachIndex(m_index);
     m_children.push_back(std::move(child));
 }
 
 void Entity::RemoveChild(Entity* child) {
+    if (child) {
+        child->AttachIndex(nullptr);
+    }
     m_children.erase(
         std::remove_if(m_children.begin(), m_children.end(),
                        [child](const std::unique_ptr<Entity>& ptr) {
@@ -113,6 +214,14 @@ void Entity::RemoveChild(Entity* child) {
 }
 
 Entity* Entity::GetChild(EntityId id, bool recursive) const {
+    if (recursive && m_index) {
+        Entity* found = m_index->Find(id);
+        for (Entity* ancestor = found ? found->m_parent : nullptr; ancestor; ancestor = ancestor->m_parent) {
+            if (ancestor == this) return found;
+        }
+        return nullptr;
+    }
+
     for (const auto& child : m_children) {
         if (child->m_id == id) {
             return child.get();
@@ -133,4 +242,54 @@ Entity* Entity::GetRoot() {
     }
     return current;
 }
+
+void Entity::AttachStorage(EntityStorage* storage) {
+    if (m_storage == storage) return;
+
+    if (m_storage) {
+        OnDetachStorage();
+        m_depth = m_storage->GetDepth(m_slot);
+        m_visible = m_storage->IsVisible(m_slot);
+        m_transform.Unbind();
+        m_storage->Release(m_slot);
+        m_storage = nullptr;
+    }
+    if (storage) {
+        m_slot = storage->Allocate(this);
+        storage->SetDepth(m_slot, m_depth);
+        storage->SetVisible(m_slot, m_visible);
+        m_transform.Bind(&storage->GetTransforms(), m_slot);
+        m_storage = storage;
+        OnAttachStorage();
+    }
+
+    // Children bind after their parent so their storage parent slot resolves
+    for (const auto& child : m_children) {
+        child->AttachStorage(storage);
+    }
+}
+
+EntityStorage* Entity::GetStorage() const { return m_storage; }
+uint32_t Entity::GetStorageSlot() const { return m_slot; }
+
+void Entity::AttachIndex(EntityIndex* index) {
+    if (m_index == index) return;
+
+    if (m_index) {
+        m_index->Remove(this);
+    }
+    m_index = index;
+    if (m_index && !m_index->Add(this)) {
+        LOG_WARN("Duplicate entity id " << m_id << ", it won't be found by id lookups");
+    }
+
+    for (const auto& child : m_children) {
+        child->AttachIndex(index);
+    }
+}
+
+EntityIndex* Entity::GetIndex() const { return m_index; }
+
+void Entity::OnAttachStorage() {}
+void Entity::OnDetachStorage() {}
 }  // namespace Cleave
\ No newline at end of file
@@ -1,21 +1,24 @@
 #pragma once
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "entities/Property.hpp"
+#include "math/Rect4.hpp"
 #include "math/Transform.hpp"
 #include "UUID.hpp"
 
-typedef std::string EntityId;
-
 namespace Cleave {
 class Renderer;
+class EntityStorage;
+class EntityIndex;
 class Entity {
 public:
     Entity(Transform transform = Transform())
-        : m_transform(transform),  m_id(GenerateUUID()) {}
+        : m_transform(transform),  m_id(GenerateId64()) {}
 
     Entity(const Entity& other) = delete;
     Entity& operator=(const Entity& other) = delete;
@@ -31,7 +34,7 @@ public:
                 child->SetParent(this);
             }
         }
-        other.m_id = "";
+        other.m_id = INVALID_ID;
         other.SetParent(nullptr);
     }
 
@@ -54,46 +57,71 @@ public:
                     child->SetParent(this);
                 }
             }
-            other.m_id = "";
+            other.m_id = INVALID_ID;
             other.SetParent(nullptr);
         }
         return *this;
     }
 
-    virtual ~Entity() = default;
-
-    struct Property {
-        enum class Types {
-            Hidden,
-            Int,
-            Float,
-            Double,
-            Bool,
-            String,
-            Vec2f,
-            FilePath,
-            EntityId,
-        };
-        std::string value;
-        Types type = Types::Hidden;
-    };
-    using PropertyMap = std::unordered_map<std::string, Property>;
-
-    void Init(const PropertyMap& properties);
+    virtual ~Entity();
+
+    static constexpr EntityId INVALID_ID = 0;
+    // Reads ids written by ToString(), and maps legacy UUID strings onto stable hashes
+    static EntityId ParseId(const std::string_view value);
+
+    // Fills in every property `source(descriptor, value)` returns true for. Values go in
+    // declaration order, so a setter can rely on the properties declared before it.
+    template <typename Source>
+    void Init(Source&& source) {
+        GetPropertyList().ForEach([&](const PropertyDescriptor& property) {
+            PropertyValue value;
+            if (source(property, value)) {
+                property.set(*this, value);
+            }
+        });
+        // Nothing has been simulated yet, so there is nothing to interpolate from
+        m_transform.SavePrevious();
+    }
 
     void Tick(float deltaTime);
     void Render(Renderer* renderer);
+    // Top-down refresh of cached world transforms for this subtree
+    void UpdateTransforms();
 
     virtual void OnTick(float deltaTime);
+    // Scenes call this on the main thread for every visible entity before recording, which may
+    // run OnRender on workers. Anything that loads resources or touches GL belongs here.
+    virtual void OnPreRender();
     virtual void OnRender(Renderer* renderer);
 
-    static const char* GetTypeName() { return "cleave::Entity"; }
+    // Whether OnTick may run on a worker thread alongside other subtrees. Types whose tick
+    // touches anything outside their own subtree, such as shared services, return false.
+    virtual bool CanTickInParallel() const;
+
+    // Whether OnRender sets the material and depth of everything it draws and leaves the
+    // render target alone, so its commands don't depend on what earlier entities left set.
+    // Scenes only record in parallel when every entity drawn says so. Plain entities draw
+    // nothing; subclasses that render opt in by overriding this.
+    virtual bool IsRenderStateSelfContained() const;
+
+    // World-space box that everything OnRender draws stays inside. Entities without one
+    // are never culled.
+    virtual bool GetWorldBounds(Rect4f& bounds);
+    // The projection OnRender sets on the renderer, for entities that set one. Scenes cull
+    // with it before anything is recorded.
+    virtual bool GetProjection(Renderer* renderer, Matrix4& projection);
+
+    static constexpr const char* GetTypeName() { return "cleave::Entity"; }
 
-    virtual const PropertyMap GetProperties() const;
-    virtual void SetProperty(const std::string_view name, const std::string& value);
+    static const PropertyList PROPERTIES;
+    virtual const PropertyList& GetPropertyList() const;
+    const PropertyDescriptor* FindProperty(const std::string_view name) const;
 
     static Entity* Create();
 
+    // Deep copy of this subtree, built from memory. Copies get fresh ids and no parent.
+    std::unique_ptr<Entity> Clone() const;
+
     EntityId GetId() const;
     void SetId(EntityId id);
 
@@ -112,9 +140,12 @@ public:
     float GetRotation();
     void SetRotation(float rotation);
 
-    int GetDepth();
+    int GetDepth() const;
     void SetDepth(int depth);
 
+    bool IsVisible() const;
+    void SetVisible(bool visible);
+
     Entity* GetParent() const;
     void SetParent(Entity* parent);
 
@@ -122,11 +153,33 @@ public:
     void AddChild(std::unique_ptr<Entity> child);
     void RemoveChild(Entity* child);
 
+    // Recursive lookups go through the scene's index when there is one
     Entity* GetChild(EntityId id, bool recursive = false) const;
 
     Entity* GetRoot();
 
+    // Moves this subtree's hot data into `storage`, or back into the entities when null
+    void AttachStorage(EntityStorage* storage);
+    EntityStorage* GetStorage() const;
+    uint32_t GetStorageSlot() const;
+
+    // Registers this subtree in `index`, or unregisters it when null
+    void AttachIndex(EntityIndex* index);
+    EntityIndex* GetIndex() const;
+
+protected:
+    // A new entity of the same type with a copy of this one's own state, children excluded
+    virtual std::unique_ptr<Entity> CloneSelf() const;
+    // Copies what every entity has, apart from its id and place in the tree, into `clone`
+    void CopyEntityState(Entity& clone) const;
+
+    // Called once the entity has a slot in its storage, and again just before losing it
+    virtual void OnAttachStorage();
+    virtual void OnDetachStorage();
+
 private:
+    static const PropertyDescriptor PROPERTY_DESCRIPTORS[];
+
     EntityId m_id;
     std::string m_name;
     Transform m_transform;
@@ -135,5 +188,8 @@ private:
     int m_depth = 0;
     bool m_active = true;
     bool m_visible = true;
+    EntityStorage* m_storage = nullptr;
+    uint32_t m_slot = 0;
+    EntityIndex* m_index = nullptr;
 };
 }  // namespace Cleave
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "entities/Property.hpp"
+
+#include <charconv>
+
+#include "entities/Entity.hpp"
+
+namespace Cleave {
+namespace {
+bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; }
+
+// Accepts the surrounding whitespace and leading '+' that stof and stoi did, e.g. "1, 2"
+template <typename T>
+bool ParseNumber(std::string_view text, T& value) {
+    while (!text.empty() && IsSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && IsSpace(text.back())) text.remove_suffix(1);
+    if (text.size() > 1 && text.front() == '+' && text[1] != '-') text.remove_prefix(1);
+
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && error == std::errc() && end == text.data() + text.size();
+}
+}  // namespace
+
+const PropertyDescriptor* PropertyList::Find(const std::string_view name) const {
+    for (const PropertyDescriptor& property : properties) {
+        if (property.name == name) return &property;
+    }
+    return base ? base->Find(name) : nullptr;
+}
+
+std::string FormatPropertyValue(const PropertyValue& value) {
+    struct Formatter {
+        std::string operator()(int value) const { return std::to_string(value); }
+        std::string operator()(float value) const { return std::to_string(value); }
+        std::string operator()(double value) const { return std::to_string(value); }
+        std::string operator()(bool value) const { return value ? "1" : "0"; }
+        std::string operator()(const std::string& value) const { return value; }
+        std::string operator()(const Vec2f& value) const { return value.ToString(); }
+        std::string operator()(EntityId value) const { return std::to_string(value); }
+    };
+    return std::visit(Formatter(), value);
+}
+
+bool ParsePropertyValue(PropertyType type, const std::string_view text, PropertyValue& value) {
+    switch (type) {
+        case PropertyType::Int: {
+            int parsed = 0;
+            if (!ParseNumber(text, parsed)) return false;
+            value = parsed;
+            return true;
+        }
+        case PropertyType::Float: {
+            float parsed = 0.0f;
+            if (!ParseNumber(text, parsed)) return false;
+            value = parsed;
+            return true;
+        }
+        case PropertyType::Double: {
+            double parsed = 0.0;
+            if (!ParseNumber(text, parsed)) return false;
+            value = parsed;
+            return true;
+        }
+        case PropertyType::Bool:
+            if (text == "1" || text == "true") {
+                value = true;
+            } else if (text == "0" || text == "false") {
+                value = false;
+            } else {
+                return false;
+            }
+            return true;
+        case PropertyType::Vec2f: {
+            const size_t comma = text.find(',');
+            Vec2f parsed;
+            if (comma == std::string_view::npos || !ParseNumber(text.substr(0, comma), parsed.x) ||
+                !ParseNumber(text.substr(comma + 1), parsed.y)) {
+                return false;
+            }
+            value = parsed;
+            return true;
+        }
+        case PropertyType::EntityId:
+            value = Entity::ParseId(text);
+            return true;
+        case PropertyType::String:
+        case PropertyType::FilePath:
+        case PropertyType::Hidden:
+            value = std::string(text);
+            return true;
+    }
+    return false;
+}
+}  // namespace Cleave
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "math/Vec2.hpp"
+
+typedef uint64_t EntityId;
+
+namespace Cleave {
+class Entity;
+
+enum class PropertyType {
+    Hidden,
+    Int,
+    Float,
+    Double,
+    Bool,
+    String,
+    Vec2f,
+    FilePath,
+    EntityId,
+};
+
+using PropertyValue = std::variant<int, float, double, bool, std::string, Vec2f, EntityId>;
+
+// One typed property of an entity type. Values pass through get/set without touching strings;
+// text only comes into it when a scene file is read or written.
+struct PropertyDescriptor {
+    std::string_view name;
+    PropertyType type = PropertyType::Hidden;
+    bool hidden = false;  // Serialized, but not shown in the editor
+    PropertyValue (*get)(const Entity& entity) = nullptr;
+    void (*set)(Entity& entity, const PropertyValue& value) = nullptr;
+};
+
+// The properties a type declares, chained to the ones its base type declares
+struct PropertyList {
+    std::string_view typeName;
+    std::span<const PropertyDescriptor> properties;
+    const PropertyList* base = nullptr;
+
+    const PropertyDescriptor* Find(const std::string_view name) const;
+
+    // Base type properties come first
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        if (base) {
+            base->ForEach(fn);
+        }
+        for (const PropertyDescriptor& property : properties) {
+            fn(property);
+        }
+    }
+};
+
+// Builds a descriptor from a typed getter and setter on E. The value type is whatever the
+// getter returns, and has to be one of PropertyValue's alternatives.
+template <typename E, typename Getter, typename Setter>
+constexpr PropertyDescriptor MakeProperty(const std::string_view name, PropertyType type, Getter, Setter, bool hidden = false) {
+    using T = std::remove_cvref_t<std::invoke_result_t<Getter, const E&>>;
+    return {
+        name,
+        type,
+        hidden,
+        [](const Entity& entity) -> PropertyValue { return Getter{}(static_cast<const E&>(entity)); },
+        [](Entity& entity, const PropertyValue& value) {
+            if (const T* typed = std::get_if<T>(&value)) {
+                Setter{}(static_cast<E&>(entity), *typed);
+            }
+        },
+    };
+}
+
+// Scene file text for a value, and back. Parsing picks the alternative from the property type.
+std::string FormatPropertyValue(const PropertyValue& value);
+bool ParsePropertyValue(PropertyType type, const std::string_view text, PropertyValue& value);
+}  // namespace Cleave
@@ -1,48 +1,65 @@
 #include "entities/SoundPlayer.hpp"
 #include "services/Services.hpp"
+#include "scene/SceneLoad.hpp"
 #include "Log.hpp"
 
 namespace Cleave {
-const Entity::PropertyMap SoundPlayer::GetProperties() const {
-    auto properties = Entity::GetProperties();
-    properties["type"] = {GetTypeName(), Property::Types::Hidden};
-    std::string soundPath;
-    if (m_sound)
-        soundPath = m_sound->GetPath();
-    else
-        soundPath = "";
-    properties["sound"] = {soundPath, Property::Types::FilePath};
-    properties["playing"] = {std::to_string(IsPlaying()), Property::Types::Bool};
-    properties["loop"] = {std::to_string(m_loop), Property::Types::Bool};
-    properties["volume"] = {std::to_string(m_volume), Property::Types::Float};
-    return properties;
+// "sound" is declared first so a scene that starts playing has something to play. Everything
+// that reaches the audio or resource manager waits for the main thread when the scene loads
+// in the background.
+const PropertyDescriptor SoundPlayer::PROPERTY_DESCRIPTORS[] = {
+    MakeProperty<SoundPlayer>("sound", PropertyType::FilePath,
+        [](const SoundPlayer& player) { return player.m_sound ? player.m_sound->GetPath() : std::string(); },
+        [](SoundPlayer& player, const std::string& path) {
+            SceneLoad::RunOnMainThread(player, [&player, path] {
+                if (auto sound = GET_RESMGR()->Get<Sound>(path)) {
+                    player.m_sound = sound;
+                } else {
+                    LOG_WARN("Sound in '" << path << "' doesn't exist");
+                }
+            });
+        }),
+    MakeProperty<SoundPlayer>("playing", PropertyType::Bool,
+        [](const SoundPlayer& player) { return player.m_playing || player.m_playOnTick; },
+        [](SoundPlayer& player, bool playing) {
+            SceneLoad::RunOnMainThread(player, [&player, playing] {
+                if (playing) {
+                    player.Play();
+                } else {
+                    player.Stop();
+                }
+            });
+        }),
+    MakeProperty<SoundPlayer>("loop", PropertyType::Bool,
+        [](const SoundPlayer& player) { return player.m_loop; },
+        [](SoundPlayer& player, bool loop) { SceneLoad::RunOnMainThread(player, [&player, loop] { player.SetLoop(loop); }); }),
+    MakeProperty<SoundPlayer>("volume", PropertyType::Float,
+        [](const SoundPlayer& player) { return player.m_volume; },
+        [](SoundPlayer& player, float volume) { SceneLoad::RunOnMainThread(player, [&player, volume] { player.SetVolume(volume); }); }),
+};
+const PropertyList SoundPlayer::PROPERTIES = {GetTypeName(), PROPERTY_DESCRIPTORS, &Entity::PROPERTIES};
+
+const PropertyList& SoundPlayer::GetPropertyList() const { return PROPERTIES; }
+
+Entity* SoundPlayer::Create() { return new SoundPlayer(); }
+
+std::unique_ptr<Entity> SoundPlayer::CloneSelf() const {
+    auto clone = std::make_unique<SoundPlayer>();
+    clone->m_sound = m_sound;
+    clone->m_loop = m_loop;
+    clone->m_volume = m_volume;
+    clone->m_playOnTick = m_playing || m_playOnTick;
+    CopyEntityState(*clone);
+    return clone;
 }
 
-void SoundPlayer::SetProperty(const std::string_view name, const std::string& value) {
-    if (name == "sound") {
-        auto sound = GET_RESMGR()->Get<Sound>(value);
-        if (sound) {
-            m_sound = sound;
-        } else {
-            LOG_WARN("Sound in '" << value << "' doesn't exist");
-        }
-    } else if (name == "playing") {
-        m_playing = std::stoi(value);
-        if (m_playing) 
-            Play(); 
-        else 
-            Stop();
-    } else if (name == "loop") {
-        SetLoop(std::stoi(value));
-    } else if (name == "volume") {
-        SetVolume(std::stof(value));
-    } else {
-        Entity::SetProperty(name, value);
+void SoundPlayer::OnTick(float deltaTime) {
+    if (m_playOnTick) {
+        m_playOnTick = false;
+        Play();
     }
 }
 
-Entity* SoundPlayer::Create() { return new SoundPlayer(); }
-
 bool SoundPlayer::IsPlaying() const { return m_playing; }
 void SoundPlayer::Play() {
     m_playing = true;
@@ -9,13 +9,19 @@ public:
     SoundPlayer() = default;
     SoundPlayer(Transform transform) : Entity(transform) {}
     
-    static const char* GetTypeName() { return "cleave::SoundPlayer"; }
+    static constexpr const char* GetTypeName() { return "cleave::SoundPlayer"; }
 
-    const PropertyMap GetProperties() const override;
-    void SetProperty(const std::string_view name, const std::string& value) override;
+    static const PropertyList PROPERTIES;
+    const PropertyList& GetPropertyList() const override;
 
     static Entity* Create();
 
+    void OnTick(float deltaTime) override;
+
+    // Talks to the audio manager
+    bool CanTickInParallel() const override { return false; }
+    bool IsRenderStateSelfContained() const override { return true; }
+
     bool IsPlaying() const;
     void Play();
     void Stop();
@@ -25,10 +31,17 @@ public:
 
     bool IsLooping() const;
     void SetLoop(bool loop);
+
+protected:
+    std::unique_ptr<Entity> CloneSelf() const override;
+
 private:
+    static const PropertyDescriptor PROPERTY_DESCRIPTORS[];
+
     std::shared_ptr<Sound> m_sound;
     SoundHandle m_soundHandle = 0;
     bool m_playing = false;
+    bool m_playOnTick = false;  // A clone of a playing player starts once it ticks in a scene
     bool m_loop = false;
     float m_volume = 1.0f;
 };
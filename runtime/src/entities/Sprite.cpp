@@ -7,76 +7,72 @@
 #include "rendering/Renderer.hpp"
 #include "rendering/Material.hpp"
 #include "resources/Texture.hpp"
+#include "scene/SceneLoad.hpp"
+#include "scene/EntityStorage.hpp"
 
 namespace Cleave {
 Sprite::Sprite(Transform transform, Material material, Vec2f origin) : Entity(transform), m_material(material), m_origin(origin) {}
 
-const Entity::PropertyMap Sprite::GetProperties() const {
-    auto properties = Entity::GetProperties();
-    properties["type"] = {GetTypeName(), Property::Types::Hidden};
-    properties["origin"] = {GetOrigin().ToString(), Property::Types::Vec2f};
-    std::string texturePath;
-    if (m_material.texture)
-        texturePath = m_material.texture->GetPath();
-    else
-        texturePath = "";
-    properties["texture"] = {texturePath, Entity::Property::Types::FilePath};
+// Resources can be loaded on first use, so they're looked up once a background load reaches the main thread
+const PropertyDescriptor Sprite::PROPERTY_DESCRIPTORS[] = {
+    MakeProperty<Sprite>("origin", PropertyType::Vec2f,
+        [](const Sprite& sprite) { return sprite.m_origin; },
+        [](Sprite& sprite, Vec2f origin) { sprite.m_origin = origin; }),
+    MakeProperty<Sprite>("texture", PropertyType::FilePath,
+        [](const Sprite& sprite) { return sprite.m_material.texture ? sprite.m_material.texture->GetPath() : std::string(); },
+        [](Sprite& sprite, const std::string& path) {
+            SceneLoad::RunOnMainThread(sprite, [&sprite, path] {
+                auto resourceManager = GET_RESMGR();
+                sprite.m_material.texture = !path.empty() && resourceManager->Exists<Texture>(path) ? resourceManager->Get<Texture>(path) : nullptr;
+            });
+        }),
+    MakeProperty<Sprite>("shader", PropertyType::FilePath,
+        [](const Sprite& sprite) { return sprite.m_material.shader ? sprite.m_material.shader->GetPath() : std::string(); },
+        [](Sprite& sprite, const std::string& path) {
+            SceneLoad::RunOnMainThread(sprite, [&sprite, path] {
+                auto resourceManager = GET_RESMGR();
+                sprite.m_material.shader = !path.empty() && resourceManager->Exists<Shader>(path) ? resourceManager->Get<Shader>(path) : nullptr;
+            });
+        }),
+};
+const PropertyList Sprite::PROPERTIES = {GetTypeName(), PROPERTY_DESCRIPTORS, &Entity::PROPERTIES};
 
-    std::string shaderPath;
-    if (m_material.shader)
-        shaderPath = m_material.shader->GetPath();
-    else
-        shaderPath = "";
-    properties["shader"] = {shaderPath, Entity::Property::Types::FilePath};
-    return properties;
-}
-
-void Sprite::SetProperty(const std::string_view name, const std::string& value) {
-    if (name == "origin") {
-        m_origin = Vec2f::FromString(value);
-    } else if (name == "texture") {
-        if (!value.empty() && GET_RESMGR()->Exists<Texture>(value)) {
-            auto tex = GET_RESMGR()->Get<Texture>(value);
-            if (tex)
-                m_material.texture = tex;
-            LOG_INFO("Set texture to " << tex->GetHandle());
-        } else {
-            m_material.texture = nullptr;
-        }
-    } else if (name == "shader") {
-        if (!value.empty() && GET_RESMGR()->Exists<Shader>(value)) {
-            auto shader = GET_RESMGR()->Get<Shader>(value);
-            if (shader)
-                m_material.shader = shader;
-        } else {
-            m_material.shader = nullptr;
-        }
-    } else {
-        Entity::SetProperty(name, value);
-    }
-}
+const PropertyList& Sprite::GetPropertyList() const { return PROPERTIES; }
 
 Entity* Sprite::Create() { return new Sprite(); }
 
-Material Sprite::GetMaterial() const { return m_material; }
+std::unique_ptr<Entity> Sprite::CloneSelf() const {
+    auto clone = std::make_unique<Sprite>(Transform(), m_material, m_origin);
+    CopyEntityState(*clone);
+    return clone;
+}
+
+const Material& Sprite::GetMaterial() const { return m_material; }
 void Sprite::SetMaterial(Material material) { m_material = material; }
 
 Vec2f Sprite::GetOrigin() const { return m_origin; }
 void Sprite::SetOrigin(Vec2f origin) { m_origin = origin; }
 
+void Sprite::OnAttachStorage() {
+    GetStorage()->AddSprite(GetStorageSlot(), &m_material);
+}
+
+bool Sprite::GetWorldBounds(Rect4f& bounds) {
+    const Transform& transform = GetTransform();
+    Vec2f size;
+    if (m_material.texture) {
+        size = {static_cast<float>(m_material.texture->GetWidth()), static_cast<float>(m_material.texture->GetHeight())};
+    }
+    bounds = Rect4f::FromQuad(transform.GetWorldPosition(), size * transform.GetWorldScale(), transform.GetWorldRotation());
+    return true;
+}
+
 void Sprite::OnRender(Renderer* renderer) {
     if (!renderer) return;
 
     if (m_material.texture != 0) {
-        Transform transform = GetTransform().GetGlobalTransform();
-        Vec2f globalPosition = transform.GetWorldPosition();
-        auto tex = m_material.texture;
-        Vec2f offset = Vec2f(tex->GetWidth() * m_origin.x,
-                            tex->GetHeight() * m_origin.y);
-                            
-        renderer->SetMaterial(m_material);
         renderer->SetDepth(GetDepth());
-        renderer->DrawSprite(transform.GetGlobalTransform(), m_material);
+        renderer->DrawSprite(GetTransform().GetGlobalTransform(), m_material);
     }
 }
 }  // namespace Cleave
\ No newline at end of file
@@ -10,21 +10,30 @@ public:
            Vec2f origin = {0.5f, 0.5f});
 
     void OnRender(Renderer* renderer) override;
+    // Sets its material and depth before drawing, which subclasses drawing differently must keep
+    bool IsRenderStateSelfContained() const override { return true; }
+    bool GetWorldBounds(Rect4f& bounds) override;
 
-    static const char* GetTypeName() { return "cleave::Sprite"; }
+    static constexpr const char* GetTypeName() { return "cleave::Sprite"; }
 
-    const PropertyMap GetProperties() const override;
-    void SetProperty(const std::string_view name, const std::string& value) override;
+    static const PropertyList PROPERTIES;
+    const PropertyList& GetPropertyList() const override;
 
     static Entity* Create();
 
-    Material GetMaterial() const;
+    const Material& GetMaterial() const;
     void SetMaterial(Material texture);
 
     Vec2f GetOrigin() const;
     void SetOrigin(Vec2f origin);
 
+protected:
+    std::unique_ptr<Entity> CloneSelf() const override;
+    void OnAttachStorage() override;
+
 private:
+    static const PropertyDescriptor PROPERTY_DESCRIPTORS[];
+
     Material m_material;
     Vec2f m_origin;
 };
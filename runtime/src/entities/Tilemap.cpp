@@ -1,46 +1,54 @@
 #include "entities/Tilemap.hpp"
+
+#include <algorithm>
+
 #include "services/ResourceManager.hpp"
 #include "rendering/Renderer.hpp"
-#include "rendering/RenderCommand.hpp"
 #include "rendering/Material.hpp"
 #include "math/Rect4.hpp"
+#include "scene/SceneLoad.hpp"
 #include "Log.hpp"
 #include "Tilemap.hpp"
 
 namespace Cleave {
 Entity* Tilemap::Create() { return new Tilemap(); }
 
-const Entity::PropertyMap Tilemap::GetProperties() const {
-    auto properties = Entity::GetProperties();
-    properties["type"] = {GetTypeName(), Property::Types::Hidden};
-    properties["width"] = {std::to_string(GetWidth()), Property::Types::Int};
-    properties["height"] = {std::to_string(GetHeight()), Property::Types::Int};
-    properties["texture"] = {m_material.texture ? m_material.texture->GetPath() : "", Entity::Property::Types::FilePath};
-    return properties;
+std::unique_ptr<Entity> Tilemap::CloneSelf() const {
+    auto clone = std::make_unique<Tilemap>();
+    clone->m_material = m_material;
+    clone->m_width = m_width;
+    clone->m_height = m_height;
+    clone->m_tiles = m_tiles;
+    CopyEntityState(*clone);
+    return clone;
 }
 
-void Tilemap::SetProperty(const std::string_view name, const std::string& value) {
-    if (name == "width") {
-        SetWidth(static_cast<uint32_t>(std::stoul(value)));
-    } else if (name == "height") {
-        SetHeight(static_cast<uint32_t>(std::stoul(value)));
-    } else if (name == "texture") {
-        if (!value.empty() && GET_RESMGR()->Exists<Texture>(value)) {
-            auto tex = GET_RESMGR()->Get<Texture>(value);
-            if (tex)
-                m_material.texture = tex;
-            LOG_INFO("Set tilemap texture to " << tex->GetHandle());
-        } else {
-            m_material.texture = nullptr;
-        }
-    }  else {
-        Entity::SetProperty(name, value);
-    }
-}
+const PropertyDescriptor Tilemap::PROPERTY_DESCRIPTORS[] = {
+    MakeProperty<Tilemap>("width", PropertyType::Int,
+        [](const Tilemap& tilemap) { return static_cast<int>(tilemap.m_width); },
+        [](Tilemap& tilemap, int width) { tilemap.SetWidth(static_cast<uint32_t>(std::max(width, 0))); }),
+    MakeProperty<Tilemap>("height", PropertyType::Int,
+        [](const Tilemap& tilemap) { return static_cast<int>(tilemap.m_height); },
+        [](Tilemap& tilemap, int height) { tilemap.SetHeight(static_cast<uint32_t>(std::max(height, 0))); }),
+    MakeProperty<Tilemap>("texture", PropertyType::FilePath,
+        [](const Tilemap& tilemap) { return tilemap.m_material.texture ? tilemap.m_material.texture->GetPath() : std::string(); },
+        [](Tilemap& tilemap, const std::string& path) {
+            SceneLoad::RunOnMainThread(tilemap, [&tilemap, path] {
+                auto resourceManager = GET_RESMGR();
+                tilemap.m_material.texture = !path.empty() && resourceManager->Exists<Texture>(path) ? resourceManager->Get<Texture>(path) : nullptr;
+            });
+        }),
+};
+const PropertyList Tilemap::PROPERTIES = {GetTypeName(), PROPERTY_DESCRIPTORS, &Entity::PROPERTIES};
+
+const PropertyList& Tilemap::GetPropertyList() const { return PROPERTIES; }
 
 void Tilemap::OnRender(Renderer* renderer) {
     if (m_tiles.empty()) return;
 
+    renderer->SetMaterial(m_material);
+    renderer->SetDepth(GetDepth());
+
     for (int y = 0; y < m_height; ++y) {
         for (int x = 0; x < m_width; ++x) {
             const Tile& tile = GetTile(x, y);
@@ -53,19 +61,29 @@ void Tilemap::OnRender(Renderer* renderer) {
                 GetScale().y
             );
 
-            RenderQuadCommand cmd(
+            Vec2f uv0 = tile.uv0;
+            Vec2f uv1 = tile.uv1;
+            if (m_material.texture) {
+                uv0 = m_material.texture->MapUV(uv0);
+                uv1 = m_material.texture->MapUV(uv1);
+            }
+
+            renderer->DrawQuad(
                 destRect,
-                1.0f, 1.0f, 0.0f,
-                m_material,
-                GetDepth(),
-                tile.uv0.x, tile.uv0.y,
-                tile.uv1.x, tile.uv1.y,
+                uv0.x, uv0.y,
+                uv1.x, uv1.y,
                 Color::White()
             );
-            renderer->AddRenderCommand(std::make_unique<RenderCommand>(cmd));
         }
     }
 }
+bool Tilemap::GetWorldBounds(Rect4f& bounds) {
+    // Tiles are laid out from the local position, matching OnRender
+    const Vec2f scale = GetScale();
+    bounds = Rect4f::FromQuad(GetPosition(), {m_width * scale.x, m_height * scale.y}, 0.0f);
+    return true;
+}
+
 void Tilemap::Resize(uint32_t width, uint32_t height) {
     m_width = width;
     m_height = height;
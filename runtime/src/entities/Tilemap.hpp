@@ -17,10 +17,12 @@ public:
     Tilemap(Transform transform) : Entity(transform) {};
 
     void OnRender(Renderer* renderer) override;
+    bool IsRenderStateSelfContained() const override { return true; }
+    bool GetWorldBounds(Rect4f& bounds) override;
 
-    static const char* GetTypeName() { return "cleave::Tilemap"; }
-    const PropertyMap GetProperties() const override;
-    void SetProperty(const std::string_view name, const std::string& value) override;
+    static constexpr const char* GetTypeName() { return "cleave::Tilemap"; }
+    static const PropertyList PROPERTIES;
+    const PropertyList& GetPropertyList() const override;
 
     static Entity* Create();
 
@@ -34,7 +36,13 @@ public:
     void SetTiles(const std::vector<Tile>& tiles);
     const Tile& GetTile(uint32_t x, uint32_t y) const;
     void SetTile(uint32_t x, uint32_t y, const Tile& tile);
+
+protected:
+    std::unique_ptr<Entity> CloneSelf() const override;
+
 private:
+    static const PropertyDescriptor PROPERTY_DESCRIPTORS[];
+
     Material m_material;
     uint32_t m_width = 0;
     uint32_t m_height = 0;
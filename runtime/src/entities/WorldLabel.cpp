@@ -3,38 +3,55 @@
 #include "services/ResourceManager.hpp"
 #include "resources/Shader.hpp"
 #include "rendering/Color.hpp"
+#include "rendering/Material.hpp"
 #include "rendering/Renderer.hpp"
+#include "scene/SceneLoad.hpp"
 
 namespace Cleave {
+constexpr const char* TEXT_SHADER_PATH = "res/shaders/text.vert";
+// Clears texture, blend mode and uniforms before the text shader is set
+const Material PLAIN_MATERIAL;
+
+WorldLabel::WorldLabel(Transform transform, const std::string& text, std::shared_ptr<Font> font)
+    : Entity(transform), m_text(text), m_font(font) {
+    if (m_font) {
+        ResolveTextShader();
+    }
+}
+
 WorldLabel::Entity* WorldLabel::Create() { return new WorldLabel(); }
 
-const Entity::PropertyMap WorldLabel::GetProperties() const {
-    auto properties = Entity::GetProperties();
-    properties["type"] = {GetTypeName(), Property::Types::Hidden};
-    properties["text"] = {m_text, Property::Types::String};
-    std::string fontPath;
-    if (m_font)
-        fontPath = m_font->GetPath();
-    else
-        fontPath = "";
-    properties["font"] = {fontPath, Property::Types::FilePath};
-    return properties;
+std::unique_ptr<Entity> WorldLabel::CloneSelf() const {
+    auto clone = std::make_unique<WorldLabel>(Transform(), m_text, m_font);
+    clone->m_color = m_color;
+    CopyEntityState(*clone);
+    return clone;
 }
 
-void WorldLabel::SetProperty(const std::string_view name, const std::string& value) {
-    if (name == "text") {
-        m_text = value;
-    } else if (name == "font") {
-        if (!value.empty()) {
-            auto font = GET_RESMGR()->Get<Font>(value);
-            if (font) {
-                m_font = font;
-            }
-        }
-    } else {
-        Entity::SetProperty(name, value);
+const PropertyDescriptor WorldLabel::PROPERTY_DESCRIPTORS[] = {
+    MakeProperty<WorldLabel>("text", PropertyType::String,
+        [](const WorldLabel& label) { return label.m_text; },
+        [](WorldLabel& label, const std::string& text) { label.m_text = text; }),
+    MakeProperty<WorldLabel>("font", PropertyType::FilePath,
+        [](const WorldLabel& label) { return label.m_font ? label.m_font->GetPath() : std::string(); },
+        [](WorldLabel& label, const std::string& path) {
+            if (path.empty()) return;
+            SceneLoad::RunOnMainThread(label, [&label, path] {
+                if (auto font = GET_RESMGR()->Get<Font>(path)) {
+                    label.SetFont(font);
+                }
+            });
+        }),
+};
+const PropertyList WorldLabel::PROPERTIES = {GetTypeName(), PROPERTY_DESCRIPTORS, &Entity::PROPERTIES};
+
+const PropertyList& WorldLabel::GetPropertyList() const { return PROPERTIES; }
+
+void WorldLabel::OnPreRender() {
+    // The handle goes stale when the shader is unloaded or reloaded, so look it up again
+    if (m_font && !m_textShader && GET_RESMGR()->Exists<Shader>(TEXT_SHADER_PATH)) {
+        ResolveTextShader();
     }
-    LOG_INFO("Property " << name << " = " << value);
 }
 
 void WorldLabel::OnRender(Renderer* renderer) {
@@ -43,10 +60,11 @@ void WorldLabel::OnRender(Renderer* renderer) {
 
     Vec2f globalPosition = GetTransform().GetWorldPosition();
 
-    auto fontShader = GET_RESMGR()->Get<Shader>("res/shaders/text.vert");
+    Shader* fontShader = m_textShader.Get();
     if (!fontShader) {
         return;
     }
+    renderer->SetMaterial(PLAIN_MATERIAL);
     renderer->SetShader(fontShader->GetHandle());
     renderer->SetDepth(GetDepth());
     renderer->DrawText(
@@ -63,7 +81,14 @@ const std::string& WorldLabel::GetText() const { return m_text; }
 void WorldLabel::SetText(const std::string& text) { m_text = text; }
 
 std::shared_ptr<Font> WorldLabel::GetFont() const { return m_font; }
-void WorldLabel::SetFont(std::shared_ptr<Font> font) { m_font = font; }
+void WorldLabel::SetFont(std::shared_ptr<Font> font) {
+    m_font = font;
+    if (m_font && !m_textShader) {
+        ResolveTextShader();
+    }
+}
+
+void WorldLabel::ResolveTextShader() { m_textShader = GET_RESMGR()->GetHandle<Shader>(TEXT_SHADER_PATH); }
 
 Color WorldLabel::GetColor() const { return m_color; }
 void WorldLabel::SetColor(const Color& color) { m_color = color; }
@@ -2,19 +2,23 @@
 
 #include "Entity.hpp"
 #include "resources/Font.hpp"
+#include "resources/ResourceHandle.hpp"
 #include "rendering/Color.hpp"
 
 namespace Cleave {
+class Shader;
+
 class WorldLabel : public Entity {
 public:
-    WorldLabel(Transform transform = Transform(), const std::string& text = "", std::shared_ptr<Font> font = nullptr)
-        : Entity(transform), m_text(text), m_font(font) {}
+    WorldLabel(Transform transform = Transform(), const std::string& text = "", std::shared_ptr<Font> font = nullptr);
 
+    void OnPreRender() override;
     void OnRender(Renderer* renderer) override;
+    bool IsRenderStateSelfContained() const override { return true; }
     
-    static const char* GetTypeName() { return "cleave::WorldLabel"; }
-    const PropertyMap GetProperties() const override;
-    void SetProperty(const std::string_view name, const std::string& value) override;
+    static constexpr const char* GetTypeName() { return "cleave::WorldLabel"; }
+    static const PropertyList PROPERTIES;
+    const PropertyList& GetPropertyList() const override;
 
     static Entity* Create();
 
@@ -26,9 +30,19 @@ public:
 
     Color GetColor() const;
     void SetColor(const Color& color);
+
+protected:
+    std::unique_ptr<Entity> CloneSelf() const override;
+
 private:
+    static const PropertyDescriptor PROPERTY_DESCRIPTORS[];
+
+    // Resolved when a font is set, and again by OnPreRender if the handle went stale
+    void ResolveTextShader();
+
     std::string m_text;
     std::shared_ptr<Font> m_font;
+    ResourceHandle<Shader> m_textShader;
     Color m_color = Color::White();
 };
 } // namespace Cleave
\ No newline at end of file
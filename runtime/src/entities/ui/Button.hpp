@@ -9,6 +9,7 @@ public:
     ~Button() = default;
 
     void OnRender(Renderer* renderer) override;
+    bool IsRenderStateSelfContained() const override { return true; }
 
 private:
     std::string m_label;
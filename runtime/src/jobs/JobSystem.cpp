@@ -0,0 +1,138 @@
+#include "jobs/JobSystem.hpp"
+
+#include "Log.hpp"
+#include "profiling/Profiler.hpp"
+
+namespace Cleave {
+namespace {
+thread_local uint32_t t_queueIndex = 0;
+}
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    if (workerCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    for (uint32_t i = 0; i <= workerCount; i++) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++) {
+        m_workers.emplace_back([this, i] {
+            CLEAVE_PROFILE_THREAD("Worker " + std::to_string(i));
+            t_queueIndex = i + 1;
+            WorkerLoop();
+        });
+    }
+    LOG_INFO("Job system started with " << workerCount << " workers");
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+uint32_t JobSystem::GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+void JobSystem::Run(TaskGroup& group, std::function<void()> task) {
+    if (m_workers.empty()) {
+        task();
+        return;
+    }
+
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        WorkQueue& queue = *m_queues[t_queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({std::move(task), &group});
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this against a worker that just found nothing and is about to sleep
+    { std::lock_guard<std::mutex> lock(m_mutex); }
+    m_wake.notify_one();
+}
+
+void JobSystem::Wait(TaskGroup& group) {
+    while (!group.IsDone()) {
+        if (!TryRunTask()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& job) {
+    if (count == 0) return;
+
+    if (m_workers.empty() || count == 1) {
+        for (uint32_t i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+
+    TaskGroup group;
+    for (uint32_t i = 0; i < count; i++) {
+        Run(group, [&job, i] { job(i); });
+    }
+    Wait(group);
+}
+
+void JobSystem::WorkerLoop() {
+    while (true) {
+        if (TryRunTask()) continue;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [this] { return m_stop || m_queued.load(std::memory_order_acquire) > 0; });
+        if (m_stop) return;
+    }
+}
+
+bool JobSystem::TryRunTask() {
+    Task task;
+    if (!PopTask(task)) return false;
+
+    task.work();
+    task.group->m_pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+bool JobSystem::PopTask(Task& task) {
+    if (m_queued.load(std::memory_order_acquire) == 0) return false;
+
+    // Newest task from our own deque first, it's the one most likely still in cache
+    const uint32_t self = t_queueIndex;
+    {
+        WorkQueue& queue = *m_queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Otherwise steal the oldest task of another thread, which tends to be the biggest
+    const uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+    for (uint32_t i = 1; i < queueCount; i++) {
+        WorkQueue& queue = *m_queues[(self + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace Cleave
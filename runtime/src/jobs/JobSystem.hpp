@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "services/Service.hpp"
+
+namespace Cleave {
+#define GET_JOBSYSTEM() Services::Get<JobSystem>()
+// Work-stealing task scheduler. Every worker owns a deque it pushes to and pops from at the
+// back, and idle threads steal from the front of the others'. Threads waiting on a group run
+// tasks while they wait, so tasks may spawn and wait on tasks of their own.
+class JobSystem : public Service {
+public:
+    // Counts the unfinished tasks started through Run with this group
+    class TaskGroup {
+    public:
+        bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+        std::atomic<uint32_t> m_pending{0};
+    };
+
+    // 0 picks one worker per hardware thread, minus the caller
+    explicit JobSystem(uint32_t workerCount = 0);
+    ~JobSystem();
+
+    static const char* GetTypeName() { return "cleave::JobSystem"; }
+
+    uint32_t GetWorkerCount() const;
+
+    // Queues `task` on the calling thread's deque. Without workers it runs immediately.
+    void Run(TaskGroup& group, std::function<void()> task);
+    // Runs queued tasks, stealing if needed, until every task in `group` has finished
+    void Wait(TaskGroup& group);
+
+    // Runs job(0) .. job(count - 1) across the pool and returns once all of them finished
+    void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& job);
+
+private:
+    struct Task {
+        std::function<void()> work;
+        TaskGroup* group = nullptr;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerLoop();
+    bool TryRunTask();
+    bool PopTask(Task& task);
+
+    std::vector<std::thread> m_workers;
+    // Index 0 is shared by threads outside the pool, workers own the rest
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::atomic<uint32_t> m_queued{0};
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+};
+}  // namespace Cleave
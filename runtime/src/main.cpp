@@ -1,6 +1,7 @@
-#define STB_IMAGE_IMPLEMENTATION
 #include <algorithm>
+#include <filesystem>
 
+#include "FrameClock.hpp"
 #include "Window.hpp"
 #include "audio/SoLoudBackend.hpp"
 #include "entities/AnimatedSprite.hpp"
@@ -9,6 +10,8 @@
 #include "entities/Sprite.hpp"
 #include "entities/Tilemap.hpp"
 #include "entities/WorldLabel.hpp"
+#include "jobs/JobSystem.hpp"
+#include "profiling/Profiler.hpp"
 #include "rendering/OpenGLRenderer.hpp"
 #include "resources/Font.hpp"
 #include "resources/Shader.hpp"
@@ -19,8 +22,8 @@
 #include "services/AudioManager.hpp"
 #include "services/InputManager.hpp"
 #include "services/ResourceManager.hpp"
+#include "services/SceneManager.hpp"
 #include "services/Services.hpp"
-#include "thirdparty/stb_image.h"
 
 using namespace Cleave;
 
@@ -39,14 +42,30 @@ constexpr const char* START_SCENE_PATH = "res/scenes/TestScene.jscn";
 using AudioBackendType = SoLoudBackend;
 
 constexpr bool USE_EDITOR = true;
+// Index res/ at startup and load each resource on first use. The editor lists resources
+// that are already loaded, so it wants this off.
+constexpr bool LAZY_RESOURCES = false;
+// Built by CleavePacker; loose files under res/ are used when it's missing
+constexpr const char* PACK_PATH = "res.pak";
+
+constexpr float FIXED_TIMESTEP = 1.0f / 60.0f;
+constexpr uint32_t MAX_STEPS_PER_FRAME = 5;
+
+constexpr uint32_t PROFILE_CAPTURE_FRAMES = 120;
+constexpr const char* PROFILE_CAPTURE_PATH = "profile.json";
 }  // namespace Config
 
 int main() {
+    CLEAVE_PROFILE_THREAD("Main");
     Window* window = new Window(Config::WINDOW_WIDTH, Config::WINDOW_HEIGHT, Config::WINDOW_TITLE);
 
     Renderer* renderer = static_cast<Renderer*>(new OpenGLRenderer());
     renderer->Initialize(*window);
 
+    // The resource scan decodes on the job system, so it has to exist first
+    JobSystem* jobSystem = new JobSystem();
+    Services::Provide<JobSystem>(jobSystem);
+
     ResourceManager* resourceManager = new ResourceManager();
     resourceManager->SetRenderer(renderer);
 
@@ -56,13 +75,32 @@ int main() {
     resourceManager->RegisterLoader(std::make_unique<SoundLoader>());
     resourceManager->RegisterLoader(std::make_unique<FontLoader>());
 
+    // The editor saves scenes back into res/, so it always works on the loose files
+    bool mountPack = std::filesystem::exists(Config::PACK_PATH);
+#ifdef CLEAVE_EDITOR_ENABLED
+    mountPack = mountPack && !Config::USE_EDITOR;
+#endif
+    if (mountPack) {
+        resourceManager->MountArchive(Config::PACK_PATH);
+    }
+
+    resourceManager->SetLazyLoading(Config::LAZY_RESOURCES);
     resourceManager->ScanResources();
 
     InputManager* input = new InputManager();
     AudioManager* audioManager = new AudioManager(resourceManager, std::make_unique<Config::AudioBackendType>());
+    SceneManager* sceneManager = new SceneManager();
     Services::Provide<InputManager>(input);
     Services::Provide<ResourceManager>(resourceManager);
     Services::Provide<AudioManager>(audioManager);
+    Services::Provide<SceneManager>(sceneManager);
+
+    if (auto spriteShader = resourceManager->Get<Shader>("res/shaders/sprite.vert")) {
+        renderer->SetDefaultShader(spriteShader->GetHandle());
+    }
+    if (auto colorShader = resourceManager->Get<Shader>("res/shaders/color.vert")) {
+        renderer->SetDefaultColorShader(colorShader->GetHandle());
+    }
 
     Registry::RegisterType<Entity>();
     Registry::RegisterType<AnimatedSprite>();
@@ -80,16 +118,38 @@ int main() {
 #endif
     {
         audioManager->PlayMusic(resourceManager->Get<Sound>("res/GMate.ogg"));
-        Scene* scene = resourceManager->Get<Scene>(Config::START_SCENE_PATH).get();
+        sceneManager->SetParallelTickEnabled(true);
+        sceneManager->SwitchTo(Config::START_SCENE_PATH);
+        input->AddAction("reload_scene", GLFW_KEY_F5);
+#ifdef CLEAVE_PROFILING
+        input->AddAction("profile_capture", GLFW_KEY_F9);
+#endif
+        FrameClock clock(Config::FIXED_TIMESTEP, Config::MAX_STEPS_PER_FRAME);
         auto lastPrintTime = std::chrono::high_resolution_clock::now();
         while (!window->shouldClose()) {
             auto now = std::chrono::high_resolution_clock::now();
+            CLEAVE_PROFILE_FRAME();
             renderer->ClearColor(Color(100, 149, 237, 255));
             renderer->BeginFrame();
             input->Update();
+#ifdef CLEAVE_PROFILING
+            if (input->IsActionJustPressed("profile_capture")) {
+                Profiler::RequestCapture(Config::PROFILE_CAPTURE_FRAMES, Config::PROFILE_CAPTURE_PATH);
+            }
+#endif
+
+            // Swaps in a finished level switch before anything of this frame touches the scene
+            sceneManager->Update();
+            Scene* scene = sceneManager->GetScene();
+            if (scene && input->IsActionJustPressed("reload_scene") && !sceneManager->IsSwitching()) {
+                sceneManager->SwitchTo(scene->GetPath());
+            }
 
-            scene->Tick();
-            scene->Render(renderer);
+            const uint32_t steps = clock.BeginFrame();
+            for (uint32_t i = 0; i < steps; i++) {
+                if (scene) scene->Tick(clock.GetFixedStep());
+            }
+            if (scene) scene->Render(renderer, clock.GetAlpha());
 
             renderer->EndFrame();
             window->swapBuffers();
@@ -101,7 +161,11 @@ int main() {
                 LOG_INFO("Frame Time: " << frameTimeMs
                                         << " FPS:" << (frameTimeMs > 0.0f ? 1000.0f / frameTimeMs : 0.0f)
                                         << " DrawCalls:" << renderer->GetDrawCalls()
-                                        << " TextureSwaps:" << renderer->GetTextureSwaps());
+                                        << " TextureSwaps:" << renderer->GetTextureSwaps()
+                                        << " Batches:" << renderer->GetBatches()
+                                        << " SkippedStateChanges:" << renderer->GetSkippedStateChanges()
+                                        << " Visited:" << (scene ? scene->GetRenderStats().visited : 0)
+                                        << " Culled:" << (scene ? scene->GetRenderStats().culled : 0));
                 lastPrintTime = end;
             }
         }
@@ -1,7 +1,26 @@
 #pragma once
+#include <cmath>
+
+#include "math/Vec2.hpp"
 
 namespace Cleave {
 struct Rect4f {
     float x, y, w, h;
+
+    bool Overlaps(const Rect4f& other) const {
+        return x <= other.x + other.w && other.x <= x + w &&
+               y <= other.y + other.h && other.y <= y + h;
+    }
+
+    // World-space box around a quad anchored at `position` that spans `size` before rotating
+    // about that anchor, the way the renderer places quads
+    static Rect4f FromQuad(Vec2f position, Vec2f size, float rotation) {
+        if (rotation == 0.0f) {
+            return {std::fmin(position.x, position.x + size.x), std::fmin(position.y, position.y + size.y),
+                    std::fabs(size.x), std::fabs(size.y)};
+        }
+        const float radius = std::sqrt(size.x * size.x + size.y * size.y);
+        return {position.x - radius, position.y - radius, radius * 2.0f, radius * 2.0f};
+    }
 };
-}  // namespace Cleave
\ No newline at end of file
+}  // namespace Cleave
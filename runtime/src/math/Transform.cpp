@@ -1,90 +1,130 @@
 #define _USE_MATH_DEFINES
 #include "Transform.hpp"
 
+#include <atomic>
 #include <cmath>
 
+#include "math/TransformStorage.hpp"
+
 namespace Cleave {
+namespace {
+// Versions are unique across all transforms, so copying one can't alias a stale child's
+std::atomic<uint64_t> s_nextWorldVersion{1};
+// Bumped by every local change anywhere, so a world cache checked since the last bump is
+// known to be current without walking up to the root
+std::atomic<uint64_t> s_changeEpoch{1};
+std::atomic<uint32_t> s_parallelPhases{0};
+
+Matrix4 ComposeMatrix(Vec2f position, Vec2f scale, float rotation) {
+    float c = std::cos(rotation);
+    float s = std::sin(rotation);
+    Matrix4 matrix;
+    matrix.m[0][0] = c * scale.x;
+    matrix.m[0][1] = -s * scale.y;
+    matrix.m[1][0] = s * scale.x;
+    matrix.m[1][1] = c * scale.y;
+    matrix.m[3][0] = position.x;
+    matrix.m[3][1] = position.y;
+    return matrix;
+}
+}  // namespace
+
 Transform::Transform(const Vec2f position, const Vec2f scale, float rotation,
                      Transform* parent)
-    : m_parent(parent) {
-    m_matrix = Matrix4::Identity();
-    Translate(position);
-    Rotate(rotation);
-    Scale(scale);
+    : m_parent(parent),
+      m_position(position),
+      m_scale(scale),
+      m_rotation(rotation),
+      m_previousPosition(position),
+      m_previousScale(scale),
+      m_previousRotation(rotation) {}
+
+Transform::Transform(const Transform& other)
+    : m_parent(other.m_parent),
+      m_position(other.GetPosition()),
+      m_scale(other.GetScale()),
+      m_rotation(other.GetRotation()),
+      m_previousPosition(m_position),
+      m_previousScale(m_scale),
+      m_previousRotation(m_rotation) {}
+
+Transform& Transform::operator=(const Transform& other) {
+    if (this == &other) return *this;
+
+    Vec2f position = other.GetPosition();
+    Vec2f scale = other.GetScale();
+    float rotation = other.GetRotation();
+    SetParent(other.m_parent);
+    SetPosition(position);
+    SetScale(scale);
+    SetRotation(rotation);
+    // Like a copy, an assigned transform starts without motion to interpolate
+    SavePrevious();
+    return *this;
 }
 
 Transform* Transform::GetParent() const { return m_parent; }
-void Transform::SetParent(Transform* parent) { m_parent = parent; }
+void Transform::SetParent(Transform* parent) {
+    m_parent = parent;
+    m_worldDirty = true;
+    s_changeEpoch.fetch_add(1, std::memory_order_relaxed);
+    if (m_storage) {
+        bool shared = parent && parent->m_storage == m_storage;
+        m_storage->SetParent(m_slot, shared ? parent->m_slot : TransformStorage::NONE);
+    }
+}
+
+void Transform::MarkDirty() {
+    m_matrixDirty = true;
+    m_worldDirty = true;
+    s_changeEpoch.fetch_add(1, std::memory_order_relaxed);
+}
 
 void Transform::Translate(Vec2f translation) {
-    m_matrix.m[3][0] += translation.x;
-    m_matrix.m[3][1] += translation.y;
+    SetPosition(GetPosition() + translation);
 }
 
 void Transform::Scale(Vec2f scale) {
-    Matrix4 scaling;
-    scaling.m[0][0] = scale.x;
-    scaling.m[1][1] = scale.y;
-    m_matrix = m_matrix * scaling;
+    SetScale(GetScale() * scale);
 }
 
 void Transform::Rotate(float radians) {
-    float c = std::cos(radians);
-    float s = std::sin(radians);
-    Matrix4 rotation;
-    rotation.m[0][0] = c;
-    rotation.m[0][1] = -s;
-    rotation.m[1][0] = s;
-    rotation.m[1][1] = c;
-    m_matrix = m_matrix * rotation;
+    SetRotation(GetRotation() + radians);
 }
 
-Vec2f Transform::GetPosition() const { return Vec2f(m_matrix.m[3][0], m_matrix.m[3][1]); }
+Vec2f Transform::GetPosition() const { return m_storage ? m_storage->GetPosition(m_slot) : m_position; }
 void Transform::SetPosition(Vec2f position) {
-    m_matrix.m[3][0] = position.x;
-    m_matrix.m[3][1] = position.y;
-}
-
-Vec2f Transform::GetScale() const {
-    return Vec2f(
-        std::sqrt(m_matrix.m[0][0] * m_matrix.m[0][0] + m_matrix.m[1][0] * m_matrix.m[1][0]),
-        std::sqrt(m_matrix.m[0][1] * m_matrix.m[0][1] + m_matrix.m[1][1] * m_matrix.m[1][1])
-    );
+    if (m_storage) {
+        m_storage->SetPosition(m_slot, position);
+    } else {
+        m_position = position;
+    }
+    MarkDirty();
 }
 
+Vec2f Transform::GetScale() const { return m_storage ? m_storage->GetScale(m_slot) : m_scale; }
 void Transform::SetScale(Vec2f scale) {
-    float currentScaleX = std::sqrt(m_matrix.m[0][0] * m_matrix.m[0][0] + m_matrix.m[1][0] * m_matrix.m[1][0]);
-    float currentScaleY = std::sqrt(m_matrix.m[0][1] * m_matrix.m[0][1] + m_matrix.m[1][1] * m_matrix.m[1][1]);
-    if (currentScaleX != 0.0f) {
-        m_matrix.m[0][0] /= currentScaleX;
-        m_matrix.m[1][0] /= currentScaleX;
+    if (m_storage) {
+        m_storage->SetScale(m_slot, scale);
+    } else {
+        m_scale = scale;
     }
-    if (currentScaleY != 0.0f) {
-        m_matrix.m[0][1] /= currentScaleY;
-        m_matrix.m[1][1] /= currentScaleY;
-    }
-
-    m_matrix.m[0][0] *= scale.x;
-    m_matrix.m[1][0] *= scale.x;
-    m_matrix.m[0][1] *= scale.y;
-    m_matrix.m[1][1] *= scale.y;
+    MarkDirty();
 }
 
-float Transform::GetRotation() const { return std::atan2(m_matrix.m[1][0], m_matrix.m[0][0]); }
+float Transform::GetRotation() const { return m_storage ? m_storage->GetRotation(m_slot) : m_rotation; }
 
 float Transform::GetRotationDegrees() const {
     return GetRotation() * (180.0f / M_PI);
 }
 
 void Transform::SetRotation(float radians) {
-    Vec2f scale = GetScale();
-    float c = std::cos(radians);
-    float s = std::sin(radians);
-
-    m_matrix.m[0][0] = c * scale.x;
-    m_matrix.m[0][1] = -s * scale.y;
-    m_matrix.m[1][0] = s * scale.x;
-    m_matrix.m[1][1] = c * scale.y;
+    if (m_storage) {
+        m_storage->SetRotation(m_slot, radians);
+    } else {
+        m_rotation = radians;
+    }
+    MarkDirty();
 }
 
 void Transform::SetRotationDegrees(float degrees) {
@@ -92,32 +132,175 @@ void Transform::SetRotationDegrees(float degrees) {
 }
 
 Transform Transform::GetGlobalTransform() const {
-    Vec2f worldPos = GetWorldPosition();
-    Vec2f worldScale = GetWorldScale();
-    float worldRot = GetWorldRotation();
-    return Transform(worldPos, worldScale, worldRot);
+    return Transform(GetWorldPosition(), GetWorldScale(), GetWorldRotation());
 }
 
 Vec2f Transform::GetWorldPosition() const {
-    if (m_parent)
-        return m_parent->GetWorldPosition() + GetPosition();
-    else
-        return GetPosition();
+    Vec2f position, scale;
+    float rotation;
+    GetWorld(position, scale, rotation);
+    return position;
 }
 
 Vec2f Transform::GetWorldScale() const {
-    if (m_parent)
-        return m_parent->GetWorldScale() * GetScale();
-    else
-        return GetScale();
+    Vec2f position, scale;
+    float rotation;
+    GetWorld(position, scale, rotation);
+    return scale;
 }
 
 float Transform::GetWorldRotation() const {
-    if (m_parent)
-        return m_parent->GetWorldRotation() + GetRotation();
-    else
-        return GetRotation();
+    Vec2f position, scale;
+    float rotation;
+    GetWorld(position, scale, rotation);
+    return rotation;
+}
+
+Matrix4 Transform::GetWorldMatrix() const {
+    if (!m_storage && EnsureWorld()) return m_worldMatrix;
+    Vec2f position, scale;
+    float rotation;
+    GetWorld(position, scale, rotation);
+    return ComposeMatrix(position, scale, rotation);
+}
+
+void Transform::GetWorld(Vec2f& position, Vec2f& scale, float& rotation) const {
+    if (m_storage) {
+        position = m_storage->GetWorldPosition(m_slot);
+        scale = m_storage->GetWorldScale(m_slot);
+        rotation = m_storage->GetWorldRotation(m_slot);
+        return;
+    }
+    if (EnsureWorld()) {
+        position = m_worldPosition;
+        scale = m_worldScale;
+        rotation = m_worldRotation;
+        return;
+    }
+
+    // Composed the way RefreshWorld does, without caching anything
+    Vec2f parentPosition = {0.0f, 0.0f};
+    Vec2f parentScale = {1.0f, 1.0f};
+    float parentRotation = 0.0f;
+    if (m_parent) {
+        m_parent->GetWorld(parentPosition, parentScale, parentRotation);
+    }
+    position = parentPosition + m_position;
+    scale = parentScale * m_scale;
+    rotation = parentRotation + m_rotation;
+}
+
+void Transform::UpdateWorldTransform() {
+    // Bound transforms are refreshed by their storage's own pass
+    if (m_storage) return;
+    if (IsWorldStale()) {
+        RefreshWorld();
+    }
+    // With the parent checked as well, queries are cache hits until the next change
+    const uint64_t epoch = s_changeEpoch.load(std::memory_order_relaxed);
+    if (!m_parent || (!m_parent->m_storage && m_parent->m_checkedEpoch == epoch)) {
+        m_checkedEpoch = epoch;
+    }
+}
+
+void Transform::BeginParallelPhase() { s_parallelPhases.fetch_add(1, std::memory_order_relaxed); }
+void Transform::EndParallelPhase() { s_parallelPhases.fetch_sub(1, std::memory_order_relaxed); }
+uint64_t Transform::GetChangeEpoch() { return s_changeEpoch.load(std::memory_order_relaxed); }
+
+bool Transform::IsWorldStale() const {
+    // A bound parent keeps no version, so its children always recompute
+    return m_worldDirty || (m_parent && (m_parent->m_storage || m_parentVersion != m_parent->m_worldVersion));
+}
+
+bool Transform::EnsureWorld() const {
+    // A bound parent's world changes in its storage's pass without bumping the epoch
+    const bool boundParent = m_parent && m_parent->m_storage;
+    const uint64_t epoch = s_changeEpoch.load(std::memory_order_relaxed);
+    if (m_checkedEpoch == epoch && !boundParent) return true;
+    // Caches are only written outside phases, so reading them above was safe
+    if (s_parallelPhases.load(std::memory_order_relaxed) != 0) return false;
+
+    if (m_parent && !boundParent) {
+        m_parent->EnsureWorld();
+    }
+    if (IsWorldStale()) {
+        RefreshWorld();
+    }
+    m_checkedEpoch = epoch;
+    return true;
+}
+
+void Transform::RefreshWorld() const {
+    // Children inherit position offset, scale and rotation separately, not the full matrix
+    if (m_parent) {
+        m_worldPosition = m_parent->GetWorldPosition() + m_position;
+        m_worldScale = m_parent->GetWorldScale() * m_scale;
+        m_worldRotation = m_parent->GetWorldRotation() + m_rotation;
+        m_parentVersion = m_parent->m_worldVersion;
+    } else {
+        m_worldPosition = m_position;
+        m_worldScale = m_scale;
+        m_worldRotation = m_rotation;
+    }
+    m_worldMatrix = ComposeMatrix(m_worldPosition, m_worldScale, m_worldRotation);
+    m_worldVersion = s_nextWorldVersion.fetch_add(1, std::memory_order_relaxed);
+    m_worldDirty = false;
+}
+
+const Matrix4& Transform::GetMatrix() const {
+    if (m_storage) {
+        m_matrix = ComposeMatrix(GetPosition(), GetScale(), GetRotation());
+        return m_matrix;
+    }
+    if (m_matrixDirty) {
+        m_matrix = ComposeMatrix(m_position, m_scale, m_rotation);
+        m_matrixDirty = false;
+    }
+    return m_matrix;
+}
+
+void Transform::SavePrevious() {
+    m_previousPosition = GetPosition();
+    m_previousScale = GetScale();
+    m_previousRotation = GetRotation();
+}
+
+bool Transform::BlendFromPrevious(float alpha) {
+    const Vec2f position = GetPosition();
+    const Vec2f scale = GetScale();
+    const float rotation = GetRotation();
+    if (position.x == m_previousPosition.x && position.y == m_previousPosition.y &&
+        scale.x == m_previousScale.x && scale.y == m_previousScale.y && rotation == m_previousRotation) {
+        return false;
+    }
+
+    SetPosition(m_previousPosition + (position - m_previousPosition) * alpha);
+    SetScale(m_previousScale + (scale - m_previousScale) * alpha);
+    SetRotation(m_previousRotation + (rotation - m_previousRotation) * alpha);
+    return true;
+}
+
+void Transform::Bind(TransformStorage* storage, uint32_t slot) {
+    if (m_storage) {
+        Unbind();
+    }
+    storage->SetPosition(slot, m_position);
+    storage->SetScale(slot, m_scale);
+    storage->SetRotation(slot, m_rotation);
+    m_storage = storage;
+    m_slot = slot;
+    SetParent(m_parent);
+}
+
+void Transform::Unbind() {
+    if (!m_storage) return;
+    m_position = m_storage->GetPosition(m_slot);
+    m_scale = m_storage->GetScale(m_slot);
+    m_rotation = m_storage->GetRotation(m_slot);
+    m_storage = nullptr;
+    MarkDirty();
 }
 
-const Matrix4& Transform::GetMatrix() const { return m_matrix; }
-}  // namespace Cleave
\ No newline at end of file
+bool Transform::IsBound() const { return m_storage != nullptr; }
+uint32_t Transform::GetSlot() const { return m_slot; }
+}  // namespace Cleave
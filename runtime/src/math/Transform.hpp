@@ -1,13 +1,27 @@
 #pragma once
+#include <cstdint>
+
 #include "math/Matrix4.hpp"
 #include "math/Vec2.hpp"
 
 namespace Cleave {
+class TransformStorage;
+
+// Local position, scale and rotation plus a cached world transform. World values are
+// refreshed lazily: each transform remembers which version of its parent's world it was
+// derived from, so a change anywhere up the chain invalidates everything below it.
+// While a parallel phase is open the world getters never write a cache: they read one that
+// is known current or compose the values from the parent chain, so workers can share ancestors.
+//
+// A transform can also be bound to a slot in a TransformStorage, in which case it is only
+// a view and every value lives in the storage's arrays. Copies of a view are plain values.
 class Transform {
 public:
     Transform(const Vec2f position = {0.0f, 0.0f},
               const Vec2f scale = {1.0f, 1.0f}, float rotation = 0.0f,
               Transform* parent = nullptr);
+    Transform(const Transform& other);
+    Transform& operator=(const Transform& other);
     ~Transform() = default;
 
     Transform* GetParent() const;
@@ -32,10 +46,64 @@ public:
     Vec2f GetWorldPosition() const;
     Vec2f GetWorldScale() const;
     float GetWorldRotation() const;
+    Matrix4 GetWorldMatrix() const;
+
+    // Refreshes the world cache assuming the parent's is already current. Walking the tree
+    // top-down with this once per frame leaves every later world query a cache hit.
+    void UpdateWorldTransform();
+
+    // Opened and closed by the thread that hands entities to workers, around the tasks
+    static void BeginParallelPhase();
+    static void EndParallelPhase();
+    // Bumped by every local change to any transform
+    static uint64_t GetChangeEpoch();
 
     const Matrix4& GetMatrix() const;
+
+    // Remembers the current local values as the state before a simulation step
+    void SavePrevious();
+    // Sets the local values `alpha` of the way from the saved state to the current one.
+    // Returns false without touching anything when nothing changed since the save.
+    bool BlendFromPrevious(float alpha);
+
+    // Moves the values into `slot` and turns this transform into a view of it
+    void Bind(TransformStorage* storage, uint32_t slot);
+    // Copies the values back out of the storage and stops being a view
+    void Unbind();
+    bool IsBound() const;
+    uint32_t GetSlot() const;
+
 private:
+    void MarkDirty();
+    bool IsWorldStale() const;
+    // True once the world cache is current. In a parallel phase it is left alone instead of
+    // refreshed, and false is returned if it would have needed that.
+    bool EnsureWorld() const;
+    void RefreshWorld() const;
+    void GetWorld(Vec2f& position, Vec2f& scale, float& rotation) const;
+
     Transform* m_parent;
-    Matrix4 m_matrix;
+    Vec2f m_position;
+    Vec2f m_scale;
+    float m_rotation;
+
+    Vec2f m_previousPosition;
+    Vec2f m_previousScale;
+    float m_previousRotation;
+
+    TransformStorage* m_storage = nullptr;
+    uint32_t m_slot = 0;
+
+    mutable Matrix4 m_matrix;
+    mutable bool m_matrixDirty = true;
+
+    mutable Vec2f m_worldPosition;
+    mutable Vec2f m_worldScale;
+    mutable float m_worldRotation = 0.0f;
+    mutable Matrix4 m_worldMatrix;
+    mutable uint64_t m_worldVersion = 0;
+    mutable uint64_t m_parentVersion = 0;
+    mutable uint64_t m_checkedEpoch = 0;
+    mutable bool m_worldDirty = true;
 };
-}  // namespace Cleave
\ No newline at end of file
+}  // namespace Cleave
@@ -0,0 +1,175 @@
+#include "math/TransformStorage.hpp"
+
+#include <algorithm>
+
+namespace Cleave {
+uint32_t TransformStorage::Allocate(Vec2f position, Vec2f scale, float rotation) {
+    uint32_t slot;
+    if (!m_free.empty()) {
+        slot = m_free.back();
+        m_free.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_alive.size());
+        const size_t size = slot + 1;
+        m_positionX.resize(size);
+        m_positionY.resize(size);
+        m_scaleX.resize(size);
+        m_scaleY.resize(size);
+        m_rotation.resize(size);
+        m_parent.resize(size);
+        m_worldX.resize(size);
+        m_worldY.resize(size);
+        m_worldScaleX.resize(size);
+        m_worldScaleY.resize(size);
+        m_worldRotation.resize(size);
+        m_alive.resize(size);
+    }
+
+    m_positionX[slot] = position.x;
+    m_positionY[slot] = position.y;
+    m_scaleX[slot] = scale.x;
+    m_scaleY[slot] = scale.y;
+    m_rotation[slot] = rotation;
+    m_parent[slot] = NONE;
+    m_alive[slot] = 1;
+    m_orderDirty = true;
+    m_worldDirty.store(true, std::memory_order_relaxed);
+    return slot;
+}
+
+void TransformStorage::Release(uint32_t slot) {
+    if (!IsAlive(slot)) return;
+    m_alive[slot] = 0;
+    m_free.push_back(slot);
+    m_orderDirty = true;
+}
+
+uint32_t TransformStorage::GetCapacity() const { return static_cast<uint32_t>(m_alive.size()); }
+bool TransformStorage::IsAlive(uint32_t slot) const { return slot < m_alive.size() && m_alive[slot]; }
+
+Vec2f TransformStorage::GetPosition(uint32_t slot) const { return {m_positionX[slot], m_positionY[slot]}; }
+void TransformStorage::SetPosition(uint32_t slot, Vec2f position) {
+    m_positionX[slot] = position.x;
+    m_positionY[slot] = position.y;
+    m_worldDirty.store(true, std::memory_order_relaxed);
+}
+
+Vec2f TransformStorage::GetScale(uint32_t slot) const { return {m_scaleX[slot], m_scaleY[slot]}; }
+void TransformStorage::SetScale(uint32_t slot, Vec2f scale) {
+    m_scaleX[slot] = scale.x;
+    m_scaleY[slot] = scale.y;
+    m_worldDirty.store(true, std::memory_order_relaxed);
+}
+
+float TransformStorage::GetRotation(uint32_t slot) const { return m_rotation[slot]; }
+void TransformStorage::SetRotation(uint32_t slot, float radians) {
+    m_rotation[slot] = radians;
+    m_worldDirty.store(true, std::memory_order_relaxed);
+}
+
+uint32_t TransformStorage::GetParent(uint32_t slot) const { return m_parent[slot]; }
+void TransformStorage::SetParent(uint32_t slot, uint32_t parent) {
+    if (m_parent[slot] == parent) return;
+    m_parent[slot] = parent;
+    m_orderDirty = true;
+    m_worldDirty.store(true, std::memory_order_relaxed);
+}
+
+Vec2f TransformStorage::GetWorldPosition(uint32_t slot) const {
+    if (!m_worldDirty.load(std::memory_order_relaxed)) return {m_worldX[slot], m_worldY[slot]};
+
+    Vec2f position;
+    for (uint32_t current = slot; current != NONE; current = m_parent[current]) {
+        position.x += m_positionX[current];
+        position.y += m_positionY[current];
+    }
+    return position;
+}
+
+Vec2f TransformStorage::GetWorldScale(uint32_t slot) const {
+    if (!m_worldDirty.load(std::memory_order_relaxed)) return {m_worldScaleX[slot], m_worldScaleY[slot]};
+
+    Vec2f scale(1.0f, 1.0f);
+    for (uint32_t current = slot; current != NONE; current = m_parent[current]) {
+        scale.x *= m_scaleX[current];
+        scale.y *= m_scaleY[current];
+    }
+    return scale;
+}
+
+float TransformStorage::GetWorldRotation(uint32_t slot) const {
+    if (!m_worldDirty.load(std::memory_order_relaxed)) return m_worldRotation[slot];
+
+    float rotation = 0.0f;
+    for (uint32_t current = slot; current != NONE; current = m_parent[current]) {
+        rotation += m_rotation[current];
+    }
+    return rotation;
+}
+
+void TransformStorage::UpdateWorld() {
+    if (m_orderDirty) {
+        RebuildOrder();
+    }
+    if (!m_worldDirty.load(std::memory_order_relaxed)) return;
+
+    for (uint32_t slot : m_order) {
+        const uint32_t parent = m_parent[slot];
+        if (parent == NONE) {
+            m_worldX[slot] = m_positionX[slot];
+            m_worldY[slot] = m_positionY[slot];
+            m_worldScaleX[slot] = m_scaleX[slot];
+            m_worldScaleY[slot] = m_scaleY[slot];
+            m_worldRotation[slot] = m_rotation[slot];
+        } else {
+            m_worldX[slot] = m_worldX[parent] + m_positionX[slot];
+            m_worldY[slot] = m_worldY[parent] + m_positionY[slot];
+            m_worldScaleX[slot] = m_worldScaleX[parent] * m_scaleX[slot];
+            m_worldScaleY[slot] = m_worldScaleY[parent] * m_scaleY[slot];
+            m_worldRotation[slot] = m_worldRotation[parent] + m_rotation[slot];
+        }
+    }
+    m_worldDirty.store(false, std::memory_order_relaxed);
+}
+
+const std::vector<uint32_t>& TransformStorage::GetOrder() const { return m_order; }
+
+void TransformStorage::RebuildOrder() {
+    // Tree level of every slot, then a counting sort by level puts parents first
+    const uint32_t capacity = GetCapacity();
+    m_levels.assign(capacity, NONE);
+    uint32_t maxLevel = 0;
+    for (uint32_t slot = 0; slot < capacity; slot++) {
+        if (!m_alive[slot] || m_levels[slot] != NONE) continue;
+
+        uint32_t level = 0;
+        uint32_t current = m_parent[slot];
+        while (current != NONE && m_levels[current] == NONE) {
+            level++;
+            current = m_parent[current];
+        }
+        uint32_t base = current == NONE ? level : m_levels[current] + 1 + level;
+
+        // Fill in the levels of the chain just walked
+        for (uint32_t node = slot; node != current; node = m_parent[node]) {
+            m_levels[node] = base--;
+        }
+        maxLevel = std::max(maxLevel, m_levels[slot]);
+    }
+
+    std::vector<uint32_t> counts(maxLevel + 2, 0);
+    for (uint32_t slot = 0; slot < capacity; slot++) {
+        if (m_alive[slot]) counts[m_levels[slot] + 1]++;
+    }
+    for (size_t i = 1; i < counts.size(); i++) {
+        counts[i] += counts[i - 1];
+    }
+    m_order.resize(counts.back());
+    for (uint32_t slot = 0; slot < capacity; slot++) {
+        if (m_alive[slot]) m_order[counts[m_levels[slot]]++] = slot;
+    }
+
+    m_orderDirty = false;
+    m_worldDirty.store(true, std::memory_order_relaxed);
+}
+}  // namespace Cleave
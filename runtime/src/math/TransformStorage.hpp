@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "math/Vec2.hpp"
+
+namespace Cleave {
+// Structure-of-arrays home for transforms in dense storage mode. Slots are stable handles;
+// world values are refreshed by one linear pass over slots ordered parents-first.
+class TransformStorage {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    uint32_t Allocate(Vec2f position, Vec2f scale, float rotation);
+    void Release(uint32_t slot);
+    uint32_t GetCapacity() const;
+    bool IsAlive(uint32_t slot) const;
+
+    Vec2f GetPosition(uint32_t slot) const;
+    void SetPosition(uint32_t slot, Vec2f position);
+
+    Vec2f GetScale(uint32_t slot) const;
+    void SetScale(uint32_t slot, Vec2f scale);
+
+    float GetRotation(uint32_t slot) const;
+    void SetRotation(uint32_t slot, float radians);
+
+    uint32_t GetParent(uint32_t slot) const;
+    void SetParent(uint32_t slot, uint32_t parent);
+
+    // Exact even between passes: a stale cache falls back to walking the parent chain
+    Vec2f GetWorldPosition(uint32_t slot) const;
+    Vec2f GetWorldScale(uint32_t slot) const;
+    float GetWorldRotation(uint32_t slot) const;
+
+    void UpdateWorld();
+
+    // Alive slots with every parent before its children, valid after UpdateWorld()
+    const std::vector<uint32_t>& GetOrder() const;
+
+private:
+    void RebuildOrder();
+
+    std::vector<float> m_positionX;
+    std::vector<float> m_positionY;
+    std::vector<float> m_scaleX;
+    std::vector<float> m_scaleY;
+    std::vector<float> m_rotation;
+    std::vector<uint32_t> m_parent;
+
+    std::vector<float> m_worldX;
+    std::vector<float> m_worldY;
+    std::vector<float> m_worldScaleX;
+    std::vector<float> m_worldScaleY;
+    std::vector<float> m_worldRotation;
+
+    std::vector<uint8_t> m_alive;
+    std::vector<uint32_t> m_free;
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_levels;
+    bool m_orderDirty = true;
+    std::atomic<bool> m_worldDirty{true};  // Set from parallel ticks
+};
+}  // namespace Cleave
@@ -0,0 +1,209 @@
+#include "profiling/Profiler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Log.hpp"
+
+namespace Cleave {
+namespace {
+struct ZoneEvent {
+    const char* name;
+    int64_t start;
+    int64_t end;
+};
+
+// Written only by its owning thread; captures read it from the main thread
+struct ThreadBuffer {
+    std::vector<ZoneEvent> events;
+    std::atomic<uint64_t> head{0};
+    uint32_t threadId = 0;
+    std::string name;
+    bool exited = false;
+};
+
+struct ProfilerState {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> threads;
+    uint32_t nextThreadId = 0;
+    std::vector<int64_t> frameStarts;
+    std::string capturePath;
+    uint32_t requestedFrames = 0;
+    uint32_t framesLeft = 0;
+    uint32_t frameThreadId = 0;
+    int64_t captureStart = 0;
+    bool capturing = false;
+};
+
+const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+ProfilerState& GetState() {
+    static ProfilerState state;
+    return state;
+}
+
+// Buffers of exited threads are only kept while a capture may still want their zones
+void RemoveExitedThreads(ProfilerState& state) {
+    std::erase_if(state.threads, [](const std::shared_ptr<ThreadBuffer>& thread) { return thread->exited; });
+}
+
+// Shared with the registry so a thread's zones survive the thread itself until the next capture
+struct ThreadBufferOwner {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ThreadBufferOwner() : buffer(std::make_shared<ThreadBuffer>()) {
+        buffer->events.resize(Profiler::EVENTS_PER_THREAD);
+
+        ProfilerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        buffer->threadId = state.nextThreadId++;
+        buffer->name = "Thread " + std::to_string(buffer->threadId);
+        state.threads.push_back(buffer);
+    }
+
+    ~ThreadBufferOwner() {
+        ProfilerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        buffer->exited = true;
+        if (!state.capturing) {
+            RemoveExitedThreads(state);
+        }
+    }
+};
+
+ThreadBuffer& GetThreadBuffer() {
+    thread_local ThreadBufferOwner owner;
+    return *owner.buffer;
+}
+
+void WriteEscaped(std::ofstream& out, const char* text) {
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        out << *c;
+    }
+}
+
+void WriteTimestamp(std::ofstream& out, int64_t nanoseconds) {
+    out << nanoseconds / 1000 << '.';
+    int64_t fraction = nanoseconds % 1000;
+    out << static_cast<char>('0' + fraction / 100) << static_cast<char>('0' + fraction / 10 % 10)
+        << static_cast<char>('0' + fraction % 10);
+}
+
+void WriteCapture(ProfilerState& state, int64_t captureEnd) {
+    std::ofstream out(state.capturePath);
+    if (!out) {
+        LOG_ERROR("Failed to open profile capture file: " << state.capturePath);
+        return;
+    }
+
+    size_t written = 0;
+    out << "{\"traceEvents\":[\n";
+    auto separator = [&] {
+        if (written++ > 0) out << ",\n";
+    };
+
+    for (const auto& thread : state.threads) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread->threadId
+            << ",\"args\":{\"name\":\"";
+        WriteEscaped(out, thread->name.c_str());
+        out << "\"}}";
+    }
+
+    for (size_t i = 0; i + 1 < state.frameStarts.size(); i++) {
+        separator();
+        out << "{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":0,\"tid\":" << state.frameThreadId << ",\"ts\":";
+        WriteTimestamp(out, state.frameStarts[i]);
+        out << ",\"dur\":";
+        WriteTimestamp(out, state.frameStarts[i + 1] - state.frameStarts[i]);
+        out << "}";
+    }
+
+    for (const auto& thread : state.threads) {
+        uint64_t head = thread->head.load(std::memory_order_acquire);
+        uint64_t first = head > Profiler::EVENTS_PER_THREAD ? head - Profiler::EVENTS_PER_THREAD : 0;
+        for (uint64_t i = first; i < head; i++) {
+            const ZoneEvent& event = thread->events[i % Profiler::EVENTS_PER_THREAD];
+            if (event.start < state.captureStart || event.end > captureEnd) continue;
+
+            separator();
+            out << "{\"name\":\"";
+            WriteEscaped(out, event.name);
+            out << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread->threadId << ",\"ts\":";
+            WriteTimestamp(out, event.start);
+            out << ",\"dur\":";
+            WriteTimestamp(out, event.end - event.start);
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    LOG_INFO("Wrote " << state.frameStarts.size() - 1 << " profiled frames to " << state.capturePath);
+}
+}  // namespace
+
+int64_t Profiler::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+void Profiler::SetThreadName(const std::string& name) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(GetState().mutex);
+    buffer.name = name;
+}
+
+void Profiler::RecordZone(const char* name, int64_t start, int64_t end) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % EVENTS_PER_THREAD] = {name, start, end};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::BeginFrame() {
+    uint32_t threadId = GetThreadBuffer().threadId;
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    int64_t now = Now();
+    if (state.capturing) {
+        state.frameStarts.push_back(now);
+        if (--state.framesLeft == 0) {
+            WriteCapture(state, now);
+            state.capturing = false;
+            state.frameStarts.clear();
+            RemoveExitedThreads(state);
+        }
+    } else if (state.requestedFrames > 0 && !state.capturePath.empty()) {
+        state.capturing = true;
+        state.framesLeft = state.requestedFrames;
+        state.requestedFrames = 0;
+        state.frameThreadId = threadId;
+        state.captureStart = now;
+        state.frameStarts.clear();
+        state.frameStarts.push_back(now);
+    }
+}
+
+void Profiler::RequestCapture(uint32_t frames, const std::string& path) {
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.capturing) {
+        LOG_WARN("Profile capture already in progress");
+        return;
+    }
+    if (frames == 0) return;
+    state.requestedFrames = frames;
+    state.capturePath = path;
+}
+
+bool Profiler::IsCapturing() {
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.capturing || state.requestedFrames > 0;
+}
+}  // namespace Cleave
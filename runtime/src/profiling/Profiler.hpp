@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace Cleave {
+// Scoped CPU zones recorded into per-thread ring buffers. Zone names must outlive the
+// capture (string literals or __func__), only the pointer is stored.
+class Profiler {
+public:
+    // Each thread keeps its last EVENTS_PER_THREAD zones; older ones are overwritten
+    static constexpr uint32_t EVENTS_PER_THREAD = 1 << 18;
+
+    // Nanoseconds on a monotonic clock since the profiler was first used
+    static int64_t Now();
+
+    static void SetThreadName(const std::string& name);
+    static void RecordZone(const char* name, int64_t start, int64_t end);
+
+    // Frame boundary on the main thread, drives pending captures
+    static void BeginFrame();
+
+    // Writes the next `frames` frames to `path` as Chrome trace_event JSON
+    static void RequestCapture(uint32_t frames, const std::string& path);
+    static bool IsCapturing();
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : m_name(name), m_start(Profiler::Now()) {}
+    ~ProfileZone() { Profiler::RecordZone(m_name, m_start, Profiler::Now()); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_start;
+};
+}  // namespace Cleave
+
+#ifdef CLEAVE_PROFILING
+#define CLEAVE_PROFILE_CONCAT_INNER(a, b) a##b
+#define CLEAVE_PROFILE_CONCAT(a, b) CLEAVE_PROFILE_CONCAT_INNER(a, b)
+#define CLEAVE_PROFILE_SCOPE(name) ::Cleave::ProfileZone CLEAVE_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define CLEAVE_PROFILE_FUNCTION() CLEAVE_PROFILE_SCOPE(__func__)
+#define CLEAVE_PROFILE_FRAME() ::Cleave::Profiler::BeginFrame()
+#define CLEAVE_PROFILE_THREAD(name) ::Cleave::Profiler::SetThreadName(name)
+#else
+#define CLEAVE_PROFILE_SCOPE(name) ((void)0)
+#define CLEAVE_PROFILE_FUNCTION() ((void)0)
+#define CLEAVE_PROFILE_FRAME() ((void)0)
+#define CLEAVE_PROFILE_THREAD(name) ((void)0)
+#endif
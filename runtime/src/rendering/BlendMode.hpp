@@ -7,6 +7,7 @@ enum class BlendMode {
     MULTIPLY,
     SUBTRACT,
     SCREEN,
+    PREMULTIPLIED,  // NORMAL for colors already multiplied by their alpha
     NONE
 };
 } // namespace Cleave
\ No newline at end of file
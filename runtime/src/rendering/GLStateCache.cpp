@@ -0,0 +1,145 @@
+#include "rendering/GLStateCache.hpp"
+
+namespace Cleave {
+void GLStateCache::Invalidate() {
+    m_program = UNKNOWN;
+    m_vertexArray = UNKNOWN;
+    m_arrayBuffer = UNKNOWN;
+    m_uniformBuffer = UNKNOWN;
+    for (GLuint& binding : m_uniformBindings) {
+        binding = UNKNOWN;
+    }
+    m_activeUnit = UNKNOWN;
+    for (GLuint& texture : m_textures) {
+        texture = UNKNOWN;
+    }
+    m_blendEnabled = -1;
+    m_blendSource = UNKNOWN;
+    m_blendDestination = UNKNOWN;
+    m_blendEquation = UNKNOWN;
+    m_framebuffer = UNKNOWN;
+    m_viewport[0] = m_viewport[1] = m_viewport[2] = m_viewport[3] = -1;
+}
+
+void GLStateCache::UseProgram(GLuint program) {
+    if (m_program == program) {
+        m_skippedCalls++;
+        return;
+    }
+    glUseProgram(program);
+    m_program = program;
+}
+
+void GLStateCache::BindVertexArray(GLuint vertexArray) {
+    if (m_vertexArray == vertexArray) {
+        m_skippedCalls++;
+        return;
+    }
+    glBindVertexArray(vertexArray);
+    m_vertexArray = vertexArray;
+}
+
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer) {
+    GLuint* current = nullptr;
+    if (target == GL_ARRAY_BUFFER) {
+        current = &m_arrayBuffer;
+    } else if (target == GL_UNIFORM_BUFFER) {
+        current = &m_uniformBuffer;
+    }
+
+    if (current && *current == buffer) {
+        m_skippedCalls++;
+        return;
+    }
+    glBindBuffer(target, buffer);
+    if (current) {
+        *current = buffer;
+    }
+}
+
+void GLStateCache::BindUniformBufferBase(GLuint index, GLuint buffer) {
+    if (index < MAX_UNIFORM_BINDINGS && m_uniformBindings[index] == buffer) {
+        m_skippedCalls++;
+        return;
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+    // Binding a range also binds the generic target
+    m_uniformBuffer = buffer;
+    if (index < MAX_UNIFORM_BINDINGS) {
+        m_uniformBindings[index] = buffer;
+    }
+}
+
+bool GLStateCache::BindTexture(GLuint unit, GLuint texture) {
+    if (unit < MAX_TEXTURE_UNITS && m_textures[unit] == texture) {
+        m_skippedCalls++;
+        return false;
+    }
+
+    if (m_activeUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeUnit = unit;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (unit < MAX_TEXTURE_UNITS) {
+        m_textures[unit] = texture;
+    }
+    return true;
+}
+
+void GLStateCache::SetBlendEnabled(bool enabled) {
+    if (m_blendEnabled == static_cast<int>(enabled)) {
+        m_skippedCalls++;
+        return;
+    }
+    if (enabled) {
+        glEnable(GL_BLEND);
+    } else {
+        glDisable(GL_BLEND);
+    }
+    m_blendEnabled = enabled;
+}
+
+void GLStateCache::BlendFunc(GLenum source, GLenum destination) {
+    if (m_blendSource == source && m_blendDestination == destination) {
+        m_skippedCalls++;
+        return;
+    }
+    glBlendFunc(source, destination);
+    m_blendSource = source;
+    m_blendDestination = destination;
+}
+
+void GLStateCache::BlendEquation(GLenum equation) {
+    if (m_blendEquation == equation) {
+        m_skippedCalls++;
+        return;
+    }
+    glBlendEquation(equation);
+    m_blendEquation = equation;
+}
+
+void GLStateCache::BindFramebuffer(GLuint framebuffer) {
+    if (m_framebuffer == framebuffer) {
+        m_skippedCalls++;
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    m_framebuffer = framebuffer;
+}
+
+void GLStateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (m_viewport[0] == x && m_viewport[1] == y && m_viewport[2] == width && m_viewport[3] == height) {
+        m_skippedCalls++;
+        return;
+    }
+    glViewport(x, y, width, height);
+    m_viewport[0] = x;
+    m_viewport[1] = y;
+    m_viewport[2] = width;
+    m_viewport[3] = height;
+}
+
+uint32_t GLStateCache::GetSkippedCalls() const { return m_skippedCalls; }
+void GLStateCache::ResetStats() { m_skippedCalls = 0; }
+}  // namespace Cleave
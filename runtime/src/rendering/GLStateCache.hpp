@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+#include <GL/glew.h>
+
+namespace Cleave {
+// Shadows the GL state the renderer touches and drops calls that wouldn't change it.
+// Anything outside the renderer (ImGui, the editor's framebuffers) can change GL behind
+// its back, so Invalidate() has to be called before relying on it again.
+class GLStateCache {
+public:
+    static constexpr uint32_t MAX_TEXTURE_UNITS = 8;
+
+    GLStateCache() { Invalidate(); }
+
+    void Invalidate();
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vertexArray);
+    // GL_ARRAY_BUFFER and GL_UNIFORM_BUFFER only; element buffers belong to the bound VAO
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindUniformBufferBase(GLuint index, GLuint buffer);
+    // Returns false when the texture was already bound to the unit
+    bool BindTexture(GLuint unit, GLuint texture);
+    void SetBlendEnabled(bool enabled);
+    void BlendFunc(GLenum source, GLenum destination);
+    void BlendEquation(GLenum equation);
+    void BindFramebuffer(GLuint framebuffer);
+    void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    uint32_t GetSkippedCalls() const;
+    void ResetStats();
+
+private:
+    static constexpr GLuint UNKNOWN = UINT32_MAX;
+    static constexpr uint32_t MAX_UNIFORM_BINDINGS = 4;
+
+    GLuint m_program = UNKNOWN;
+    GLuint m_vertexArray = UNKNOWN;
+    GLuint m_arrayBuffer = UNKNOWN;
+    GLuint m_uniformBuffer = UNKNOWN;
+    GLuint m_uniformBindings[MAX_UNIFORM_BINDINGS];
+    GLuint m_activeUnit = UNKNOWN;
+    GLuint m_textures[MAX_TEXTURE_UNITS];
+    int m_blendEnabled = -1;
+    GLenum m_blendSource = UNKNOWN;
+    GLenum m_blendDestination = UNKNOWN;
+    GLenum m_blendEquation = UNKNOWN;
+    GLuint m_framebuffer = UNKNOWN;
+    GLint m_viewport[4] = {-1, -1, -1, -1};
+
+    uint32_t m_skippedCalls = 0;
+};
+}  // namespace Cleave
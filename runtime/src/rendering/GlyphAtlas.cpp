@@ -0,0 +1,229 @@
+#include "rendering/GlyphAtlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Log.hpp"
+
+namespace Cleave {
+bool GlyphAtlas::Initialize(const std::vector<TextureHandle>& pageTextures) {
+    m_pageTextures = pageTextures;
+    if (FT_Init_FreeType(&m_library)) {
+        LOG_ERROR("Couldn't init FreeType Library");
+        m_library = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void GlyphAtlas::Terminate() {
+    for (auto& [handle, face] : m_faces) {
+        FT_Done_Face(face);
+    }
+    m_faces.clear();
+    m_fontData.clear();
+    m_glyphs.clear();
+    m_pages.clear();
+
+    if (m_library) {
+        FT_Done_FreeType(m_library);
+        m_library = nullptr;
+    }
+}
+
+bool GlyphAtlas::LoadFont(FontHandle handle, std::vector<uint8_t> data, int size) {
+    if (!m_library) return false;
+
+    // The map entry's buffer doesn't move once it's in, even when the map rehashes
+    const std::vector<uint8_t>& stored = m_fontData[handle] = std::move(data);
+    FT_Face face;
+    if (FT_New_Memory_Face(m_library, stored.data(), static_cast<FT_Long>(stored.size()), 0, &face)) {
+        LOG_ERROR("Failed to load font " << handle);
+        m_fontData.erase(handle);
+        return false;
+    }
+
+    FT_Set_Pixel_Sizes(face, 0, size);
+    m_faces[handle] = face;
+    return true;
+}
+
+void GlyphAtlas::BeginFrame() { m_frame++; }
+
+const Glyph* GlyphAtlas::GetGlyph(FontHandle font, uint32_t codepoint) {
+    const uint64_t key = (static_cast<uint64_t>(font) << 32) | codepoint;
+
+    auto it = m_glyphs.find(key);
+    if (it != m_glyphs.end()) {
+        if (it->second.shelf != -1) {
+            m_pages[it->second.page].shelves[it->second.shelf].lastUsed = m_frame;
+        }
+        return &it->second.glyph;
+    }
+
+    auto faceIt = m_faces.find(font);
+    if (faceIt == m_faces.end()) return nullptr;
+
+    FT_Face face = faceIt->second;
+    if (FT_Load_Char(face, codepoint, FT_LOAD_RENDER)) {
+        LOG_WARN("Failed to load Glyph for character: " << codepoint);
+        return nullptr;
+    }
+
+    const FT_Bitmap& bitmap = face->glyph->bitmap;
+    CachedGlyph cached;
+    cached.glyph.size = {static_cast<int>(bitmap.width), static_cast<int>(bitmap.rows)};
+    cached.glyph.bearing = {face->glyph->bitmap_left, face->glyph->bitmap_top};
+    cached.glyph.advance = face->glyph->advance.x;
+
+    // Whitespace only needs its metrics
+    if (cached.glyph.size.x > 0 && cached.glyph.size.y > 0) {
+        Vec2i position;
+        if (!Allocate(cached.glyph.size.x, cached.glyph.size.y, cached.page, cached.shelf, position)) {
+            LOG_WARN("Glyph atlas is full, can't place character: " << codepoint);
+            return nullptr;
+        }
+
+        Page& page = m_pages[cached.page];
+        for (int row = 0; row < cached.glyph.size.y; row++) {
+            std::memcpy(&page.pixels[(position.y + row) * PAGE_SIZE + position.x],
+                        bitmap.buffer + row * bitmap.pitch, cached.glyph.size.x);
+        }
+        MarkDirty(page, position.x, position.y, cached.glyph.size.x, cached.glyph.size.y);
+
+        page.shelves[cached.shelf].glyphs.push_back(key);
+        page.shelves[cached.shelf].lastUsed = m_frame;
+
+        cached.glyph.texture = page.texture;
+        cached.glyph.u0 = static_cast<float>(position.x) / PAGE_SIZE;
+        cached.glyph.v0 = static_cast<float>(position.y) / PAGE_SIZE;
+        cached.glyph.u1 = static_cast<float>(position.x + cached.glyph.size.x) / PAGE_SIZE;
+        cached.glyph.v1 = static_cast<float>(position.y + cached.glyph.size.y) / PAGE_SIZE;
+    }
+
+    return &m_glyphs.emplace(key, cached).first->second.glyph;
+}
+
+bool GlyphAtlas::Allocate(int width, int height, uint32_t& page, int& shelf, Vec2i& position) {
+    for (uint32_t i = 0; i < m_pages.size(); i++) {
+        shelf = m_pages[i].packer.Pack(width, height, position);
+        if (shelf != -1) {
+            page = i;
+            m_pages[i].shelves.resize(m_pages[i].packer.GetShelfCount());
+            return true;
+        }
+    }
+
+    if (m_pages.size() < m_pageTextures.size()) {
+        Page& newPage = m_pages.emplace_back();
+        newPage.texture = m_pageTextures[m_pages.size() - 1];
+        newPage.pixels.assign(PAGE_SIZE * PAGE_SIZE, 0);
+        MarkDirty(newPage, 0, 0, PAGE_SIZE, PAGE_SIZE);
+
+        shelf = newPage.packer.Pack(width, height, position);
+        if (shelf != -1) {
+            page = static_cast<uint32_t>(m_pages.size() - 1);
+            newPage.shelves.resize(newPage.packer.GetShelfCount());
+            return true;
+        }
+    }
+
+    // Every page is full: reuse the stalest shelf that is tall enough and not drawn from this frame
+    int victimPage = -1;
+    int victimShelf = -1;
+    uint64_t oldest = m_frame;
+    for (uint32_t i = 0; i < m_pages.size(); i++) {
+        Page& candidate = m_pages[i];
+        for (int s = 0; s < static_cast<int>(candidate.shelves.size()); s++) {
+            if (candidate.packer.GetShelfHeight(s) <= height) continue;
+            if (candidate.shelves[s].lastUsed < oldest) {
+                oldest = candidate.shelves[s].lastUsed;
+                victimPage = static_cast<int>(i);
+                victimShelf = s;
+            }
+        }
+    }
+
+    if (victimPage == -1) return false;
+
+    Page& victim = m_pages[victimPage];
+    EvictShelf(victim, victimShelf);
+    shelf = victim.packer.Pack(width, height, position);
+    if (shelf == -1) return false;
+
+    page = static_cast<uint32_t>(victimPage);
+    victim.shelves.resize(victim.packer.GetShelfCount());
+    return true;
+}
+
+void GlyphAtlas::EvictShelf(Page& page, int shelf) {
+    ShelfUsage& usage = page.shelves[shelf];
+    for (uint64_t key : usage.glyphs) {
+        m_glyphs.erase(key);
+    }
+    usage.glyphs.clear();
+    usage.lastUsed = 0;
+
+    page.packer.ClearShelf(shelf);
+
+    // Wipe the old coverage so linear filtering can't pick it up at the edges of new glyphs
+    const int y = page.packer.GetShelfY(shelf);
+    const int height = page.packer.GetShelfHeight(shelf);
+    std::fill(page.pixels.begin() + y * PAGE_SIZE, page.pixels.begin() + (y + height) * PAGE_SIZE, 0);
+    MarkDirty(page, 0, y, PAGE_SIZE, height);
+}
+
+void GlyphAtlas::MarkDirty(Page& page, int x, int y, int width, int height) {
+    if (!page.dirty) {
+        page.dirty = true;
+        page.dirtyMinX = x;
+        page.dirtyMinY = y;
+        page.dirtyMaxX = x + width;
+        page.dirtyMaxY = y + height;
+        return;
+    }
+    page.dirtyMinX = std::min(page.dirtyMinX, x);
+    page.dirtyMinY = std::min(page.dirtyMinY, y);
+    page.dirtyMaxX = std::max(page.dirtyMaxX, x + width);
+    page.dirtyMaxY = std::max(page.dirtyMaxY, y + height);
+}
+
+size_t GlyphAtlas::GetPageCount() const { return m_pages.size(); }
+GlyphAtlas::Page& GlyphAtlas::GetPage(size_t index) { return m_pages[index]; }
+
+uint32_t GlyphAtlas::DecodeUtf8(const std::string_view text, size_t& index) {
+    constexpr uint32_t REPLACEMENT = 0xFFFD;
+    const unsigned char lead = static_cast<unsigned char>(text[index++]);
+    if (lead < 0x80) return lead;
+
+    int length;
+    uint32_t codepoint;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 1;
+        codepoint = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 2;
+        codepoint = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 3;
+        codepoint = lead & 0x07;
+    } else {
+        return REPLACEMENT;
+    }
+
+    for (int i = 0; i < length; i++) {
+        if (index >= text.size()) return REPLACEMENT;
+        const unsigned char next = static_cast<unsigned char>(text[index]);
+        if ((next & 0xC0) != 0x80) return REPLACEMENT;
+        codepoint = (codepoint << 6) | (next & 0x3F);
+        index++;
+    }
+
+    // Reject overlong encodings, surrogates and anything past the Unicode range
+    static constexpr uint32_t MIN_CODEPOINT[] = {0, 0x80, 0x800, 0x10000};
+    if (codepoint < MIN_CODEPOINT[length] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        return REPLACEMENT;
+    }
+    return codepoint;
+}
+}  // namespace Cleave
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "rendering/Renderer.hpp"
+#include "rendering/ShelfPacker.hpp"
+
+namespace Cleave {
+// CPU side of the font atlas. Glyphs are rasterized with FreeType the first time they are
+// asked for and copied into R8 pages; the renderer uploads each page's dirty rect before
+// drawing. When every page is full, the least recently used shelf that wasn't touched this
+// frame is evicted and reused.
+class GlyphAtlas {
+public:
+    static constexpr int PAGE_SIZE = 1024;
+
+    struct ShelfUsage {
+        uint64_t lastUsed = 0;
+        std::vector<uint64_t> glyphs;
+    };
+
+    struct Page {
+        TextureHandle texture = 0;
+        std::vector<uint8_t> pixels;
+        ShelfPacker packer{PAGE_SIZE, PAGE_SIZE};
+        std::vector<ShelfUsage> shelves;
+        bool dirty = false;
+        int dirtyMinX = 0, dirtyMinY = 0, dirtyMaxX = 0, dirtyMaxY = 0;
+    };
+
+    // One page is created per handle, on demand, so the handles also cap the atlas size
+    bool Initialize(const std::vector<TextureHandle>& pageTextures);
+    void Terminate();
+
+    // FreeType reads the face from `data` for as long as the font exists, so the atlas keeps it
+    bool LoadFont(FontHandle handle, std::vector<uint8_t> data, int size);
+    void BeginFrame();
+
+    // Returns nullptr for unknown fonts, or when the glyph can't be placed
+    const Glyph* GetGlyph(FontHandle font, uint32_t codepoint);
+
+    size_t GetPageCount() const;
+    Page& GetPage(size_t index);
+
+    // Decodes the codepoint starting at `index` and advances past it. Malformed input yields U+FFFD.
+    static uint32_t DecodeUtf8(const std::string_view text, size_t& index);
+
+private:
+    struct CachedGlyph {
+        Glyph glyph;
+        uint32_t page = 0;
+        int shelf = -1;
+    };
+
+    bool Allocate(int width, int height, uint32_t& page, int& shelf, Vec2i& position);
+    void EvictShelf(Page& page, int shelf);
+    void MarkDirty(Page& page, int x, int y, int width, int height);
+
+    FT_Library m_library = nullptr;
+    std::unordered_map<FontHandle, FT_Face> m_faces;
+    std::unordered_map<FontHandle, std::vector<uint8_t>> m_fontData;
+    std::unordered_map<uint64_t, CachedGlyph> m_glyphs;
+    std::vector<Page> m_pages;
+    std::vector<TextureHandle> m_pageTextures;
+    uint64_t m_frame = 1;
+};
+}  // namespace Cleave
@@ -2,6 +2,9 @@
 
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <numbers>
 
 #include "thirdparty/stb_image.h"
@@ -9,25 +12,48 @@
 #include "Window.hpp"
 #include "rendering/RenderCommand.hpp"
 #include "rendering/Material.hpp"
+#include "profiling/Profiler.hpp"
 
 namespace Cleave {
+namespace {
+GLenum GetGLFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R: return GL_RED;
+        case TextureFormat::RG: return GL_RG;
+        case TextureFormat::RGB: return GL_RGB;
+        default: return GL_RGBA;
+    }
+}
+
+GLint GetGLInternalFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R: return GL_R8;
+        case TextureFormat::RG: return GL_RG8;
+        case TextureFormat::RGB: return GL_RGB8;
+        default: return GL_RGBA8;
+    }
+}
+}  // namespace
+
+thread_local OpenGLRenderer::RecordBucket* OpenGLRenderer::s_recordBucket = nullptr;
+
 OpenGLRenderer::~OpenGLRenderer() { Terminate(); }
 
-void OpenGLRenderer::ApplyMaterialUniforms(const Material& material) const {
-    for (const auto& kv : material.intUniforms) {
+void OpenGLRenderer::ApplyMaterialUniforms(const UniformValues& values) const {
+    for (const auto& kv : values.ints) {
         SetShaderUniformInt(kv.first, kv.second);
     }
 
-    for (const auto& kv : material.floatUniforms) {
+    for (const auto& kv : values.floats) {
         SetShaderUniformFloat(kv.first, kv.second);
     }
 
-    for (const auto& kv : material.vec2fUniforms) {
+    for (const auto& kv : values.vec2fs) {
         const Vec2f& v = kv.second;
         SetShaderUniformVector2f(kv.first, v.x, v.y);
     }
 
-    for (const auto& kv : material.matrix4Uniforms) {
+    for (const auto& kv : values.matrix4s) {
         SetShaderUniformMatrix4(kv.first, kv.second);
     }
 }
@@ -37,291 +63,418 @@ void OpenGLRenderer::Initialize(Window& window) {
     glfwMakeContextCurrent(window.getGLFWwindow());
     glewInit();
     LOG_INFO("OpenGL version:" << glGetString(GL_VERSION));
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    float vertices[] = {
-        // x, y, u, v
-        0.0f, 1.0f, 0.0f, 1.0f,  // top-left
-        1.0f, 1.0f, 1.0f, 1.0f,  // top-right
-        1.0f, 0.0f, 1.0f, 0.0f,  // bottom-right
-        0.0f, 0.0f, 0.0f, 0.0f   // bottom-left
-    };
-
-    uint32_t indices[] = {0, 1, 2, 0, 2, 3};
+    m_glState.SetBlendEnabled(true);
+    m_glState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_glState.BlendEquation(GL_FUNC_ADD);
+
+    // Every batch is written into the stream buffer, the VAOs below only describe its layouts
+    m_stream.Create(STREAM_REGION_SIZE, &m_glState);
+
+    // Quads are streamed every frame, so the index buffer can be built once for the largest batch
+    std::vector<uint32_t> indices(MAX_BATCH_QUADS * 6);
+    for (uint32_t i = 0; i < MAX_BATCH_QUADS; i++) {
+        uint32_t base = i * 4;
+        indices[i * 6 + 0] = base + 0;
+        indices[i * 6 + 1] = base + 1;
+        indices[i * 6 + 2] = base + 2;
+        indices[i * 6 + 3] = base + 0;
+        indices[i * 6 + 4] = base + 2;
+        indices[i * 6 + 5] = base + 3;
+    }
 
-    glGenVertexArrays(1, &m_quadVAO);
-    glGenBuffers(1, &m_quadVBO);
-    glGenBuffers(1, &m_quadEBO);
+    glGenVertexArrays(1, &m_batchVAO);
+    glGenBuffers(1, &m_batchEBO);
 
-    glBindVertexArray(m_quadVAO);
+    m_glState.BindVertexArray(m_batchVAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    m_glState.BindBuffer(GL_ARRAY_BUFFER, m_stream.GetBuffer());
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quadEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_batchEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
 
     // position
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*)offsetof(BatchVertex, x));
     glEnableVertexAttribArray(0);
 
     // uv
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*)offsetof(BatchVertex, u));
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
+    // color
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(BatchVertex), (void*)offsetof(BatchVertex, r));
+    glEnableVertexAttribArray(2);
 
-    if (FT_Init_FreeType(&m_ftLibrary)) {
-        LOG_ERROR("Couldn't init FreeType Library");
-    }
-}
+    m_glState.BindVertexArray(0);
 
-void OpenGLRenderer::Terminate() {
-    FT_Done_FreeType(m_ftLibrary);
-}
+    m_batchVertices.reserve(MAX_BATCH_QUADS * 4);
 
-void OpenGLRenderer::BeginFrame() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    m_drawCalls = 0; 
-    m_textureSwaps = 0;
-    m_renderCommands.clear();
-}
+    // Instanced sprites share one unit quad and the batch index buffer; everything else comes per instance
+    const float unitQuad[] = {
+        0.0f, 1.0f,
+        1.0f, 1.0f,
+        1.0f, 0.0f,
+        0.0f, 0.0f
+    };
 
-void OpenGLRenderer::EndFrame() {
-    std::stable_sort(m_renderCommands.begin(), m_renderCommands.end(),
-        [](const auto& a, const auto& b) {
-            if (a->renderTarget != b->renderTarget) return a->renderTarget < b->renderTarget;
-            if (a->depth != b->depth) return a->depth < b->depth;
-            if (a->material.texture != b->material.texture) return a->material.texture < b->material.texture;
-            if (a->material.shader != b->material.shader) return a->material.shader < b->material.shader;
-            return false;
-        });
+    glGenVertexArrays(1, &m_instanceVAO);
+    glGenBuffers(1, &m_unitQuadVBO);
 
-    for (auto& command : m_renderCommands) {
-        if (!command) continue;
-        RenderCommand* rawCmd = command.get();
+    m_glState.BindVertexArray(m_instanceVAO);
 
-        if (command->renderTarget != m_currentRenderTarget) {
-            UseRenderTarget(command->renderTarget);
-        }
+    m_glState.BindBuffer(GL_ARRAY_BUFFER, m_unitQuadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(unitQuad), unitQuad, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
 
-        Transform transform = Transform();
-        switch (rawCmd->type) {
-            case RenderCommand::Type::Quad: {
-                RenderQuadCommand* quadCmd = static_cast<RenderQuadCommand*>(rawCmd);
-                if (!quadCmd) break;
-                Rect4f rect = quadCmd->rect;
-                transform.SetPosition({rect.x, rect.y});
-                transform.SetRotation(quadCmd->rotation);
-                transform.SetScale({quadCmd->scaleX, quadCmd->scaleY});
-                auto shader = quadCmd->material.shader;
-                if (shader) {
-                    if (m_currentShader != shader->GetHandle()) {
-                        UseShader(shader->GetHandle());
-                        SetShaderUniformMatrix4("projection", GetProjection());
-                        SetShaderUniformMatrix4("model", transform.GetMatrix());
-                        SetShaderUniformVector4f("color", 
-                            quadCmd->color.r / 255.0f, 
-                            quadCmd->color.g / 255.0f, 
-                            quadCmd->color.b / 255.0f, 
-                            quadCmd->color.a / 255.0f);
-                        ApplyMaterialUniforms(quadCmd->material);
-                    }
-                }
-
-                SetBlendMode(quadCmd->material.blendMode);
-
-                auto texture = quadCmd->material.texture;
-                if (texture) {
-                    if (m_currentTexture != texture->GetHandle()) {
-                        UseTexture(texture->GetHandle());
-                    }
-                }
-
-                glBindVertexArray(m_quadVAO);
-
-                float vertices[] = {
-                    // x, y, u, v
-                    rect.x, rect.y + rect.h, quadCmd->u0, quadCmd->v1,     // top-left
-                    rect.x + rect.w, rect.y + rect.h, quadCmd->u1, quadCmd->v1,   // top-right
-                    rect.x + rect.w, rect.y, quadCmd->u1, quadCmd->v0,     // bottom-right
-                    rect.x, rect.y, quadCmd->u0, quadCmd->v0             // bottom-left
-                };
-
-                glBindBuffer(GL_ARRAY_BUFFER, m_quadVBO);
-                glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
-                break;
-            }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_batchEBO);
 
-            case RenderCommand::Type::Line: {
-                RenderLineCommand* lineCmd = static_cast<RenderLineCommand*>(rawCmd);
-                if (!lineCmd) break;
+    // Per-instance attributes are pointed into the stream buffer on every flush
+    for (GLuint attribute = 3; attribute <= 6; attribute++) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
 
-                if (lineCmd->material.shader) { 
-                    UseShader(lineCmd->material.shader->GetHandle());
-                    SetShaderUniformMatrix4("projection", GetProjection());
-                }
+    m_glState.BindVertexArray(0);
 
-                glBindTexture(GL_TEXTURE_2D, 0);
-                float vertices[] = {
-                    lineCmd->x1, lineCmd->y1, lineCmd->color.r / 255.0f, lineCmd->color.g / 255.0f, lineCmd->color.b / 255.0f, lineCmd->color.a / 255.0f,
-                    lineCmd->x2, lineCmd->y2, lineCmd->color.r / 255.0f, lineCmd->color.g / 255.0f, lineCmd->color.b / 255.0f, lineCmd->color.a / 255.0f
-                };
-                GLubyte indices[] = {0, 1};
+    m_instances.reserve(MAX_BATCH_INSTANCES);
 
-                unsigned int vao, vbo, ebo;
-                glGenVertexArrays(1, &vao);
-                glGenBuffers(1, &vbo);
-                glGenBuffers(1, &ebo);
+    glGenVertexArrays(1, &m_colorVAO);
+    m_glState.BindVertexArray(m_colorVAO);
+    m_glState.BindBuffer(GL_ARRAY_BUFFER, m_stream.GetBuffer());
 
-                glBindVertexArray(vao);
+    // position
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ColorVertex), (void*)offsetof(ColorVertex, x));
+    glEnableVertexAttribArray(0);
 
-                glBindBuffer(GL_ARRAY_BUFFER, vbo);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    // color
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ColorVertex), (void*)offsetof(ColorVertex, r));
+    glEnableVertexAttribArray(1);
 
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    m_glState.BindVertexArray(0);
 
-                // Position
-                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-                glEnableVertexAttribArray(0);
+    m_colorVertices.reserve(MAX_BATCH_COLOR_VERTICES);
 
-                // Color
-                glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
-                glEnableVertexAttribArray(1);
+    glGenBuffers(1, &m_frameUniformBuffer);
+    m_glState.BindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+    m_glState.BindBuffer(GL_UNIFORM_BUFFER, 0);
+    m_startTime = std::chrono::steady_clock::now();
 
-                glDrawElements(GL_LINES, 2, GL_UNSIGNED_BYTE, 0);
+    // Page handles are reserved up front; their GL storage is created on first upload
+    std::vector<TextureHandle> glyphPages(MAX_GLYPH_PAGES);
+    for (TextureHandle& page : glyphPages) {
+        page = NEXT_TEXTURE_HANDLE++;
+    }
+    m_glyphAtlas.Initialize(glyphPages);
+}
 
-                glDeleteVertexArrays(1, &vao);
-                glDeleteBuffers(1, &vbo);
-                glDeleteBuffers(1, &ebo);
-                break;
-            }
+void OpenGLRenderer::Terminate() {
+    m_glyphAtlas.Terminate();
+    m_stream.Destroy();
+    glDeleteVertexArrays(1, &m_batchVAO);
+    glDeleteBuffers(1, &m_batchEBO);
+    m_batchVAO = m_batchEBO = 0;
+    glDeleteVertexArrays(1, &m_instanceVAO);
+    glDeleteBuffers(1, &m_unitQuadVBO);
+    m_instanceVAO = m_unitQuadVBO = 0;
+    glDeleteVertexArrays(1, &m_colorVAO);
+    m_colorVAO = 0;
+    glDeleteBuffers(1, &m_frameUniformBuffer);
+    m_frameUniformBuffer = 0;
+}
 
-            case RenderCommand::Type::Rect: {
-                RenderRectCommand* rectCmd = static_cast<RenderRectCommand*>(rawCmd);
-                if (!rectCmd) break;
-                Rect4f rect = rectCmd->rect;
-                if (rectCmd->material.shader) { 
-                    UseShader(rectCmd->material.shader->GetHandle());
-                    SetShaderUniformMatrix4("projection", GetProjection());
-                }
+Matrix4 OpenGLRenderer::GetDefaultProjection() {
+    return Matrix4::Ortho(0.0f, 512.0f, 288.0f, 0.0f, -1.0f, 1.0f);
+}
 
-                glBindTexture(GL_TEXTURE_2D, 0);
+void OpenGLRenderer::BeginFrame() {
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    m_projection = GetDefaultProjection();
+    m_drawCalls = 0; 
+    m_textureSwaps = 0;
+    m_batches = 0;
+    m_glState.ResetStats();
+    // Whatever ran since the last frame (ImGui, the editor) may have changed GL state
+    m_glState.Invalidate();
+    m_renderQueue.Clear();
+    // Uniform values live in the queue, so the index from the previous frame is stale
+    m_submit.uniforms = RenderCommand::NO_UNIFORMS;
+    m_glyphAtlas.BeginFrame();
+}
 
-                float vertices[] = {
-                    // Position        // Color
-                    rect.x, rect.y + rect.h, rectCmd->color.r / 255.0f, rectCmd->color.g / 255.0f, rectCmd->color.b / 255.0f, rectCmd->color.a / 255.0f,
-                    rect.x + rect.w, rect.y + rect.h, rectCmd->color.r / 255.0f, rectCmd->color.g / 255.0f, rectCmd->color.b / 255.0f, rectCmd->color.a / 255.0f,
-                    rect.x + rect.w, rect.y, rectCmd->color.r / 255.0f, rectCmd->color.g / 255.0f, rectCmd->color.b / 255.0f, rectCmd->color.a / 255.0f,
-                    rect.x, rect.y, rectCmd->color.r / 255.0f, rectCmd->color.g / 255.0f, rectCmd->color.b / 255.0f, rectCmd->color.a / 255.0f
-                };
+void OpenGLRenderer::EndFrame() {
+    CLEAVE_PROFILE_SCOPE("Renderer::EndFrame");
+    // The caller may have bound its own framebuffer or program since BeginFrame
+    m_glState.Invalidate();
+    m_stream.BeginFrame();
+    UploadFrameUniforms();
+    UploadGlyphPages();
+    {
+        CLEAVE_PROFILE_SCOPE("RenderQueue::Sort");
+        m_renderQueue.Sort();
+    }
+    // Target 0 means whatever framebuffer the caller bound before submitting
+    m_boundRenderTarget = 0;
 
-                unsigned int indices[] = {0, 1, 2, 0, 2, 3};
+    for (size_t i = 0; i < m_renderQueue.GetSize(); i++) {
+        const RenderCommand& command = m_renderQueue.GetSorted(i);
+        if (command.type == RenderCommand::Type::Quad) {
+            PushQuad(command);
+        } else {
+            PushPrimitive(command);
+        }
+    }
+    FlushBatch();
 
-                unsigned int VAO, VBO, EBO;
-                glGenVertexArrays(1, &VAO);
-                glGenBuffers(1, &VBO);
-                glGenBuffers(1, &EBO);
+    if (m_boundRenderTarget != 0) {
+        UseRenderTarget(0);
+    }
+    m_stream.EndFrame();
+}
 
-                glBindVertexArray(VAO);
+void OpenGLRenderer::PushQuad(const RenderCommand& command) {
+    BatchState state;
+    state.renderTarget = command.renderTarget;
+    state.shader = command.shader;
+    state.texture = command.texture;
+    state.blendMode = command.blendMode;
+    state.uniforms = command.uniforms;
+    bool instanced = m_instancingEnabled && command.shader && m_instancedShaders.contains(command.shader);
+    state.kind = instanced ? BatchKind::Instances : BatchKind::Quads;
+
+    // Custom uniforms can't be merged, so such quads get a batch of their own
+    if (state != m_batchState || state.uniforms != RenderCommand::NO_UNIFORMS ||
+        m_batchVertices.size() >= MAX_BATCH_QUADS * 4 || m_instances.size() >= MAX_BATCH_INSTANCES) {
+        FlushBatch();
+        m_batchState = state;
+    }
 
-                glBindBuffer(GL_ARRAY_BUFFER, VBO);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    const RenderCommand::QuadData& quad = command.quad;
+    const Rect4f& rect = quad.rect;
+    const float c = std::cos(quad.rotation);
+    const float s = std::sin(quad.rotation);
+
+    if (instanced) {
+        const float w = rect.w * quad.scaleX;
+        const float h = rect.h * quad.scaleY;
+        m_instances.push_back({
+            {w * c, w * s},
+            {-h * s, h * c},
+            {rect.x, rect.y},
+            quad.u0, quad.v0, quad.u1, quad.v1,
+            command.color.r, command.color.g, command.color.b, command.color.a
+        });
+        return;
+    }
 
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    const float corners[4][4] = {
+        // x, y, u, v
+        {0.0f, rect.h, quad.u0, quad.v1},    // top-left
+        {rect.w, rect.h, quad.u1, quad.v1},  // top-right
+        {rect.w, 0.0f, quad.u1, quad.v0},    // bottom-right
+        {0.0f, 0.0f, quad.u0, quad.v0}       // bottom-left
+    };
 
-                // Position attribute
-                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-                glEnableVertexAttribArray(0);
+    for (const auto& corner : corners) {
+        float lx = corner[0] * quad.scaleX;
+        float ly = corner[1] * quad.scaleY;
+        m_batchVertices.push_back({
+            rect.x + lx * c - ly * s,
+            rect.y + lx * s + ly * c,
+            corner[2], corner[3],
+            command.color.r, command.color.g, command.color.b, command.color.a
+        });
+    }
+}
 
-                // Color attribute
-                glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
-                glEnableVertexAttribArray(1);
+void OpenGLRenderer::PushPrimitive(const RenderCommand& command) {
+    BatchState state;
+    state.renderTarget = command.renderTarget;
+    state.shader = command.shader;
+    state.blendMode = command.blendMode;
+    state.uniforms = command.uniforms;
+    state.kind = command.type == RenderCommand::Type::Line ? BatchKind::Lines : BatchKind::Triangles;
+
+    int segments = 0;
+    size_t vertexCount = 0;
+    switch (command.type) {
+        case RenderCommand::Type::Line:
+            vertexCount = 2;
+            break;
+        case RenderCommand::Type::Rect:
+            vertexCount = 6;
+            break;
+        case RenderCommand::Type::Circle:
+            segments = std::clamp(command.circle.segments, 3, MAX_CIRCLE_SEGMENTS);
+            vertexCount = static_cast<size_t>(segments) * 3;
+            break;
+        default:
+            return;
+    }
 
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    if (state != m_batchState || state.uniforms != RenderCommand::NO_UNIFORMS ||
+        m_colorVertices.size() + vertexCount > MAX_BATCH_COLOR_VERTICES) {
+        FlushBatch();
+        m_batchState = state;
+    }
 
-                glDeleteVertexArrays(1, &VAO);
-                glDeleteBuffers(1, &VBO);
-                glDeleteBuffers(1, &EBO);
-                break;
-            }
+    const Color& color = command.color;
+    auto push = [&](float x, float y) {
+        m_colorVertices.push_back({x, y, color.r, color.g, color.b, color.a});
+    };
 
-            case RenderCommand::Type::Circle: {
-                RenderCircleCommand* circleCmd = static_cast<RenderCircleCommand*>(rawCmd);
-                if (!circleCmd) break;
-                if (rawCmd->material.shader) { 
-                    UseShader(rawCmd->material.shader->GetHandle());
-                    SetShaderUniformMatrix4("projection", GetProjection());
-                }
-                std::vector<float> vertices;
-                vertices.insert(vertices.end(), {circleCmd->x, circleCmd->y, circleCmd->color.r / 255.0f, circleCmd->color.g / 255.0f, circleCmd->color.b / 255.0f, circleCmd->color.a / 255.0f});
+    switch (command.type) {
+        case RenderCommand::Type::Line: {
+            const RenderCommand::LineData& line = command.line;
+            push(line.x1, line.y1);
+            push(line.x2, line.y2);
+            break;
+        }
 
-                for (int i = 0; i <= circleCmd->segments; i++) {
-                    float angle = 2.0f * (float)std::numbers::pi * i / circleCmd->segments;
-                    float px = circleCmd->x + circleCmd->radius * cos(angle);
-                    float py = circleCmd->y + circleCmd->radius * sin(angle);
+        case RenderCommand::Type::Rect: {
+            const Rect4f& rect = command.rect.rect;
+            push(rect.x, rect.y + rect.h);
+            push(rect.x + rect.w, rect.y + rect.h);
+            push(rect.x + rect.w, rect.y);
+            push(rect.x, rect.y + rect.h);
+            push(rect.x + rect.w, rect.y);
+            push(rect.x, rect.y);
+            break;
+        }
 
-                    vertices.insert(vertices.end(), {px, py, circleCmd->color.r / 255.0f, circleCmd->color.g / 255.0f, circleCmd->color.b / 255.0f, circleCmd->color.a / 255.0f});
-                }
+        case RenderCommand::Type::Circle: {
+            const RenderCommand::CircleData& circle = command.circle;
+            const std::vector<Vec2f>& unit = GetCircleTable(segments);
+            for (int i = 0; i < segments; i++) {
+                push(circle.x, circle.y);
+                push(circle.x + circle.radius * unit[i].x, circle.y + circle.radius * unit[i].y);
+                push(circle.x + circle.radius * unit[i + 1].x, circle.y + circle.radius * unit[i + 1].y);
+            }
+            break;
+        }
 
-                std::vector<uint32_t> indices;
-                for (int i = 0; i < circleCmd->segments; i++) {
-                    indices.insert(indices.end(), {0, (uint32_t)(i + 1), (uint32_t)(i + 2)});
-                }
+        default:
+            break;
+    }
+}
 
-                unsigned int VAO, VBO, EBO;
-                glGenVertexArrays(1, &VAO);
-                glGenBuffers(1, &VBO);
-                glGenBuffers(1, &EBO);
+const std::vector<Vec2f>& OpenGLRenderer::GetCircleTable(int segments) {
+    std::vector<Vec2f>& table = m_circleTables[segments];
+    if (table.empty()) {
+        table.reserve(segments + 1);
+        for (int i = 0; i <= segments; i++) {
+            float angle = 2.0f * (float)std::numbers::pi * i / segments;
+            table.emplace_back(std::cos(angle), std::sin(angle));
+        }
+    }
+    return table;
+}
+
+void OpenGLRenderer::FlushBatch() {
+    if (m_batchVertices.empty() && m_instances.empty() && m_colorVertices.empty()) return;
 
-                glBindVertexArray(VAO);
+    if (m_batchState.renderTarget != m_boundRenderTarget) {
+        UseRenderTarget(m_batchState.renderTarget);
+    }
 
-                glBindBuffer(GL_ARRAY_BUFFER, VBO);
-                glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    if (m_batchState.shader) {
+        const auto& programs = m_batchState.kind == BatchKind::Instances ? m_instancedShaders : m_shaders;
+        auto it = programs.find(m_batchState.shader);
+        if (it != programs.end()) {
+            BindProgram(m_batchState.shader, it->second);
+        }
+        if (m_batchState.uniforms != RenderCommand::NO_UNIFORMS) {
+            ApplyMaterialUniforms(m_renderQueue.GetUniforms(m_batchState.uniforms));
+        }
+    }
 
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+    SetBlendMode(m_batchState.blendMode);
 
-                // Position attribute
-                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-                glEnableVertexAttribArray(0);
+    if (m_batchState.texture) {
+        UseTexture(m_batchState.texture);
+    }
 
-                // Color attribute
-                glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
-                glEnableVertexAttribArray(1);
+    switch (m_batchState.kind) {
+        case BatchKind::Quads: {
+            size_t offset = m_stream.Write(m_batchVertices.data(), m_batchVertices.size() * sizeof(BatchVertex), sizeof(BatchVertex));
+            m_glState.BindVertexArray(m_batchVAO);
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(m_batchVertices.size() / 4 * 6), GL_UNSIGNED_INT, 0,
+                                     static_cast<GLint>(offset / sizeof(BatchVertex)));
+            break;
+        }
 
-                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+        case BatchKind::Instances: {
+            size_t offset = m_stream.Write(m_instances.data(), m_instances.size() * sizeof(SpriteInstance), sizeof(SpriteInstance));
+            m_glState.BindVertexArray(m_instanceVAO);
+            // Without base-instance draws (GL 4.2) the attributes have to follow the write offset
+            m_glState.BindBuffer(GL_ARRAY_BUFFER, m_stream.GetBuffer());
+            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, axisX)));
+            glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, origin)));
+            glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, u0)));
+            glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteInstance), (void*)(offset + offsetof(SpriteInstance, r)));
+            glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(m_instances.size()));
+            break;
+        }
 
-                glDeleteVertexArrays(1, &VAO);
-                glDeleteBuffers(1, &VBO);
-                glDeleteBuffers(1, &EBO);
-                break;
-            }
+        case BatchKind::Lines:
+        case BatchKind::Triangles: {
+            size_t offset = m_stream.Write(m_colorVertices.data(), m_colorVertices.size() * sizeof(ColorVertex), sizeof(ColorVertex));
+            m_glState.BindVertexArray(m_colorVAO);
+            glDrawArrays(m_batchState.kind == BatchKind::Lines ? GL_LINES : GL_TRIANGLES,
+                         static_cast<GLint>(offset / sizeof(ColorVertex)), static_cast<GLsizei>(m_colorVertices.size()));
+            break;
         }
-        m_drawCalls++;
     }
+
+    m_batchVertices.clear();
+    m_instances.clear();
+    m_colorVertices.clear();
+    m_batchState = BatchState();
+    m_drawCalls++;
+    m_batches++;
 }
 
 uint32_t OpenGLRenderer::GetDrawCalls() const { return m_drawCalls; }
 uint32_t OpenGLRenderer::GetTextureSwaps() const { return m_textureSwaps; }
+uint32_t OpenGLRenderer::GetBatches() const { return m_batches; }
+uint32_t OpenGLRenderer::GetSkippedStateChanges() const { return m_glState.GetSkippedCalls(); }
+
+bool OpenGLRenderer::IsInstancingEnabled() const { return m_instancingEnabled; }
+void OpenGLRenderer::SetInstancingEnabled(bool enabled) { m_instancingEnabled = enabled; }
+
+void OpenGLRenderer::UploadFrameUniforms() {
+    FrameUniforms frame;
+    std::memcpy(frame.projection, m_projection.m, sizeof(frame.projection));
+    frame.viewport[0] = m_viewport.x;
+    frame.viewport[1] = m_viewport.y;
+    frame.viewport[2] = m_viewport.w;
+    frame.viewport[3] = m_viewport.h;
+    frame.time = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_startTime).count();
+    frame.padding[0] = frame.padding[1] = frame.padding[2] = 0.0f;
+
+    m_glState.BindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame);
+    m_glState.BindUniformBufferBase(FRAME_UNIFORM_BINDING, m_frameUniformBuffer);
+}
 
-int OpenGLRenderer::GetDepth() const { return m_depth; }
-void OpenGLRenderer::SetDepth(int depth) { m_depth = depth; }
+int OpenGLRenderer::GetDepth() const { return GetSubmitState().depth; }
+void OpenGLRenderer::SetDepth(int depth) { GetSubmitState().depth = depth; }
 
 Matrix4 OpenGLRenderer::GetProjection() const { return m_projection; }
 void OpenGLRenderer::SetProjection(Matrix4 projection) {
+    // Applied when the buckets are merged, so the last one in recording order wins
+    if (s_recordBucket) {
+        s_recordBucket->projection = projection;
+        s_recordBucket->hasProjection = true;
+        return;
+    }
     m_projection = projection;
 }
 
 Rect4f OpenGLRenderer::GetViewPort() const { return m_viewport; }
 void OpenGLRenderer::SetViewPort(Rect4f viewport) {
     m_viewport = viewport;
-    glViewport(static_cast<GLsizei>(viewport.x), static_cast<GLsizei>(viewport.y), static_cast<GLsizei>(viewport.w), static_cast<GLsizei>(viewport.h));
+    m_glState.Viewport(static_cast<GLsizei>(viewport.x), static_cast<GLsizei>(viewport.y), static_cast<GLsizei>(viewport.w), static_cast<GLsizei>(viewport.h));
 }
 
 BlendMode OpenGLRenderer::GetBlendMode() const {
@@ -329,46 +482,76 @@ BlendMode OpenGLRenderer::GetBlendMode() const {
 }
 
 void OpenGLRenderer::SetBlendMode(BlendMode mode) {
-    if (m_blendMode == mode) return;
     m_blendMode = mode;
 
-    switch (mode) {
-        case BlendMode::NONE:
-            glDisable(GL_BLEND);
-            break;
+    if (mode == BlendMode::NONE) {
+        m_glState.SetBlendEnabled(false);
+        return;
+    }
+    m_glState.SetBlendEnabled(true);
+    m_glState.BlendEquation(mode == BlendMode::SUBTRACT ? GL_FUNC_REVERSE_SUBTRACT : GL_FUNC_ADD);
 
+    switch (mode) {
         case BlendMode::NORMAL:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            m_glState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
             break;
 
         case BlendMode::ADD:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        case BlendMode::SUBTRACT:
+            m_glState.BlendFunc(GL_SRC_ALPHA, GL_ONE);
             break;
 
         case BlendMode::MULTIPLY:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_DST_COLOR, GL_ZERO);
+            m_glState.BlendFunc(GL_DST_COLOR, GL_ZERO);
             break;
 
-        case BlendMode::SUBTRACT:
-            glEnable(GL_BLEND);
-            glBlendEquation(GL_FUNC_REVERSE_SUBTRACT);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        case BlendMode::SCREEN:
+            m_glState.BlendFunc(GL_ONE_MINUS_DST_COLOR, GL_ONE);
             break;
 
-        case BlendMode::SCREEN:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_ONE_MINUS_DST_COLOR, GL_ONE);
+        case BlendMode::PREMULTIPLIED:
+            m_glState.BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+
+        default:
             break;
     }
 }
 
 ShaderHandle OpenGLRenderer::CreateShader(const std::string_view vertex, const std::string_view fragment) {
+    ShaderProgram program;
+    if (!BuildProgram(vertex, fragment, program)) {
+        return -1;
+    }
+
+    ShaderHandle handle = NEXT_SHADER_HANDLE++;
+    m_shaders[handle] = std::move(program);
+
+    // Shaders written with an instanced path get a second program built with the define enabled
+    if (vertex.find("CLEAVE_INSTANCED") != std::string_view::npos) {
+        std::string instancedVertex(vertex);
+        size_t version = instancedVertex.find("#version");
+        size_t insertAt = 0;
+        if (version != std::string::npos) {
+            size_t lineEnd = instancedVertex.find('\n', version);
+            insertAt = lineEnd == std::string::npos ? instancedVertex.size() : lineEnd + 1;
+        }
+        instancedVertex.insert(insertAt, "#define CLEAVE_INSTANCED\n");
+
+        ShaderProgram instanced;
+        if (BuildProgram(instancedVertex, fragment, instanced)) {
+            m_instancedShaders[handle] = std::move(instanced);
+        }
+    }
+
+    return handle;
+}
+
+bool OpenGLRenderer::BuildProgram(const std::string_view vertex, const std::string_view fragment, ShaderProgram& program) {
     GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
     const char* vertexSource = vertex.data();
-    glShaderSource(vertexShader, 1, &vertexSource, nullptr);
+    GLint vertexLength = static_cast<GLint>(vertex.size());
+    glShaderSource(vertexShader, 1, &vertexSource, &vertexLength);
     glCompileShader(vertexShader);
 
     GLint success;
@@ -377,12 +560,14 @@ ShaderHandle OpenGLRenderer::CreateShader(const std::string_view vertex, const s
         char infoLog[512];
         glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
         LOG_ERROR("Vertex shader compilation failed: " << infoLog);
-        return -1;
+        glDeleteShader(vertexShader);
+        return false;
     }
 
     GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
     const char* fragmentSource = fragment.data();
-    glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
+    GLint fragmentLength = static_cast<GLint>(fragment.size());
+    glShaderSource(fragmentShader, 1, &fragmentSource, &fragmentLength);
     glCompileShader(fragmentShader);
 
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
@@ -390,7 +575,9 @@ ShaderHandle OpenGLRenderer::CreateShader(const std::string_view vertex, const s
         char infoLog[512];
         glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
         LOG_ERROR("Fragment shader compilation failed: " << infoLog);
-        return -1;
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return false;
     }
 
     GLuint shaderProgram = glCreateProgram();
@@ -403,93 +590,160 @@ ShaderHandle OpenGLRenderer::CreateShader(const std::string_view vertex, const s
         char infoLog[512];
         glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
         LOG_ERROR("Shader program linking failed: " << infoLog);
-        return -1;
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        glDeleteProgram(shaderProgram);
+        return false;
     }
 
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
 
-    ShaderHandle handle = NEXT_SHADER_HANDLE++;
-    m_shaders[handle] = shaderProgram;
+    program.program = shaderProgram;
 
-    return handle;
+    GLuint frameBlock = glGetUniformBlockIndex(shaderProgram, "FrameData");
+    if (frameBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(shaderProgram, frameBlock, FRAME_UNIFORM_BINDING);
+    }
+
+    GLint uniformCount = 0;
+    glGetProgramiv(shaderProgram, GL_ACTIVE_UNIFORMS, &uniformCount);
+    for (GLint i = 0; i < uniformCount; i++) {
+        char name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(shaderProgram, static_cast<GLuint>(i), sizeof(name), &length, &size, &type, name);
+
+        // Block members have no location of their own
+        GLint location = glGetUniformLocation(shaderProgram, name);
+        if (location == -1) continue;
+
+        std::string_view uniformName(name, length);
+        if (uniformName.ends_with("[0]")) {
+            uniformName.remove_suffix(3);
+        }
+
+        UniformId id = GetUniformId(uniformName);
+        if (id >= program.uniformLocations.size()) {
+            program.uniformLocations.resize(id + 1, -1);
+        }
+        program.uniformLocations[id] = location;
+    }
+
+    return true;
 }
 
 void OpenGLRenderer::SetShader(ShaderHandle handle) {
-    m_currentShader = handle;
+    GetSubmitState().shader = handle;
 }
 
+ShaderHandle OpenGLRenderer::GetDefaultShader() const { return m_defaultShader; }
+void OpenGLRenderer::SetDefaultShader(ShaderHandle handle) { m_defaultShader = handle; }
+
+ShaderHandle OpenGLRenderer::GetDefaultColorShader() const { return m_defaultColorShader; }
+void OpenGLRenderer::SetDefaultColorShader(ShaderHandle handle) { m_defaultColorShader = handle; }
+
 void OpenGLRenderer::UseShader(ShaderHandle handle) {
-    glUseProgram(m_shaders[handle]);
-    SetShader(handle);
+    auto it = m_shaders.find(handle);
+    if (it == m_shaders.end()) {
+        LOG_WARN("Invalid shader handle: " << handle);
+        return;
+    }
+    BindProgram(handle, it->second);
 }
 
-void OpenGLRenderer::SetShaderUniformInt(const std::string_view name, int value) const {
-    GLint location = glGetUniformLocation(m_shaders.at(m_currentShader), name.data());
-    if (location == -1) {
-        LOG_WARN("Shader: " << m_currentShader << " ERROR::SHADER::UNIFORM_NOT_FOUND (" << name << ")");
-        return;
+void OpenGLRenderer::BindProgram(ShaderHandle handle, const ShaderProgram& program) {
+    m_glState.UseProgram(program.program);
+    m_boundShader = handle;
+    m_boundProgram = &program;
+}
+
+GLint OpenGLRenderer::GetUniformLocation(UniformId id) const {
+    if (!m_boundProgram) return -1;
+
+    if (id < m_boundProgram->uniformLocations.size() && m_boundProgram->uniformLocations[id] != -1) {
+        return m_boundProgram->uniformLocations[id];
     }
-    glUniform1i(location, value);
+
+    if (m_boundProgram->warnedUniforms.insert(id).second) {
+        LOG_WARN("Shader: " << m_boundShader << " ERROR::SHADER::UNIFORM_NOT_FOUND (" << GetUniformName(id) << ")");
+    }
+    return -1;
+}
+
+void OpenGLRenderer::SetShaderUniformInt(const std::string_view name, int value) const {
+    SetShaderUniformInt(GetUniformId(name), value);
 }
 
 void OpenGLRenderer::SetShaderUniformFloat(const std::string_view name, float value) const {
-    GLint location = glGetUniformLocation(m_shaders.at(m_currentShader), name.data());
-    if (location == -1) {
-        LOG_WARN("Shader: " << m_currentShader << " ERROR::SHADER::UNIFORM_NOT_FOUND (" << name << ")");
-        return;
-    }
-    glUniform1f(location, value);
+    SetShaderUniformFloat(GetUniformId(name), value);
 }
 
 void OpenGLRenderer::SetShaderUniformVector2f(const std::string_view name, float x,
                                 float y) const {
-    GLint location = glGetUniformLocation(m_shaders.at(m_currentShader), name.data());
-    if (location == -1) {
-        LOG_WARN("Shader: " << m_currentShader << " ERROR::SHADER::UNIFORM_NOT_FOUND (" << name << ")");
-        return;
-    }
-    glUniform2f(location, x, y);
+    SetShaderUniformVector2f(GetUniformId(name), x, y);
 }
 
 void OpenGLRenderer::SetShaderUniformVector3f(const std::string_view name, float x, float y,
                                 float z) const {
-    GLint location = glGetUniformLocation(m_shaders.at(m_currentShader), name.data());
-    if (location == -1) {
-        LOG_WARN("Shader: " << m_currentShader << " ERROR::SHADER::UNIFORM_NOT_FOUND (" << name << ")");
-        return;
-    }
-    glUniform3f(location, x, y, z);
+    SetShaderUniformVector3f(GetUniformId(name), x, y, z);
 }
 
 void OpenGLRenderer::SetShaderUniformVector4f(const std::string_view name, float x, float y,
                                 float z, float w) const {
-    GLint location = glGetUniformLocation(m_shaders.at(m_currentShader), name.data());
-    if (location == -1) {
-        LOG_WARN("Shader: " << m_currentShader <<  " ERROR::SHADER::UNIFORM_NOT_FOUND (" << name << ")");
-        return;
-    }
-    glUniform4f(location, x, y, z, w);
+    SetShaderUniformVector4f(GetUniformId(name), x, y, z, w);
 }
 
 void OpenGLRenderer::SetShaderUniformMatrix4(const std::string_view name,
                                Matrix4 matrix) const {
-    GLint location = glGetUniformLocation(m_shaders.at(m_currentShader), name.data());
-    if (location == -1) {
-        LOG_WARN("Shader: " << m_currentShader <<  " ERROR::SHADER::UNIFORM_NOT_FOUND (" << name << ")");
-        return;
-    }
+    SetShaderUniformMatrix4(GetUniformId(name), matrix);
+}
+
+void OpenGLRenderer::SetShaderUniformInt(UniformId id, int value) const {
+    GLint location = GetUniformLocation(id);
+    if (location == -1) return;
+    glUniform1i(location, value);
+}
+
+void OpenGLRenderer::SetShaderUniformFloat(UniformId id, float value) const {
+    GLint location = GetUniformLocation(id);
+    if (location == -1) return;
+    glUniform1f(location, value);
+}
+
+void OpenGLRenderer::SetShaderUniformVector2f(UniformId id, float x, float y) const {
+    GLint location = GetUniformLocation(id);
+    if (location == -1) return;
+    glUniform2f(location, x, y);
+}
+
+void OpenGLRenderer::SetShaderUniformVector3f(UniformId id, float x, float y, float z) const {
+    GLint location = GetUniformLocation(id);
+    if (location == -1) return;
+    glUniform3f(location, x, y, z);
+}
+
+void OpenGLRenderer::SetShaderUniformVector4f(UniformId id, float x, float y, float z, float w) const {
+    GLint location = GetUniformLocation(id);
+    if (location == -1) return;
+    glUniform4f(location, x, y, z, w);
+}
+
+void OpenGLRenderer::SetShaderUniformMatrix4(UniformId id, Matrix4 matrix) const {
+    GLint location = GetUniformLocation(id);
+    if (location == -1) return;
     glUniformMatrix4fv(location, 1, false, (float*)matrix.m);
 }
 
 void OpenGLRenderer::SetTexture(TextureHandle handle) {
-    m_currentTexture = handle;
+    GetSubmitState().texture = handle;
 }
 
 void OpenGLRenderer::UseTexture(TextureHandle handle) {
-    glBindTexture(GL_TEXTURE_2D, m_textures[handle]);
-    SetTexture(handle);
-    m_textureSwaps++;
+    if (m_glState.BindTexture(0, m_textures[handle])) {
+        m_textureSwaps++;
+    }
 }
 
 Renderer::TextureInfo OpenGLRenderer::CreateFallbackTexture() {
@@ -505,7 +759,7 @@ Renderer::TextureInfo OpenGLRenderer::CreateFallbackTexture() {
 
     GLuint glHandle;
     glGenTextures(1, &glHandle);
-    glBindTexture(GL_TEXTURE_2D, glHandle);
+    m_glState.BindTexture(0, glHandle);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -518,7 +772,6 @@ Renderer::TextureInfo OpenGLRenderer::CreateFallbackTexture() {
     m_textureInfos[handle] = info;
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, info.width, info.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-    glBindTexture(GL_TEXTURE_2D, 0);
     return info;
 }
 
@@ -527,7 +780,7 @@ Renderer::TextureInfo OpenGLRenderer::CreateTexture(const std::string_view path)
     GLuint glHandle;
 
     glGenTextures(1, &glHandle);
-    glBindTexture(GL_TEXTURE_2D, glHandle);
+    m_glState.BindTexture(0, glHandle);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -543,37 +796,76 @@ Renderer::TextureInfo OpenGLRenderer::CreateTexture(const std::string_view path)
     TextureHandle handle = NEXT_TEXTURE_HANDLE++;
     m_textures[handle] = glHandle;
 
-    GLenum format;
-    switch (channels) {
-        case 1:
-            format = GL_RED;
-            info.format = TextureFormat::R;
-            break;
-        case 2:
-            format = GL_RG;
-            info.format = TextureFormat::RG;
-            break;
-        case 3:
-            format = GL_RGB;
-            info.format = TextureFormat::RGB;
-            break;
-        default:
-            format = GL_RGBA;
-            info.format = TextureFormat::RGBA;
-            break;
-    }
-
+    // stb_image expands every image to RGBA, whatever its channel count
+    info.format = TextureFormat::RGBA;
     info.handle = handle;
     m_textureInfos[handle] = info;
 
-    GLenum internalFormat = (channels == 4) ? GL_RGBA : GL_RGB;
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, info.width, info.height, 0, format, GL_UNSIGNED_BYTE, data);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, info.width, info.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
 
     stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
     return info;
 }
 
+Renderer::TextureInfo OpenGLRenderer::CreateTexture(const uint8_t* pixels, int width, int height, TextureFormat format, bool repeat) {
+    return CreateTexture(std::span<const uint8_t* const>(&pixels, 1), width, height, format, repeat);
+}
+
+Renderer::TextureInfo OpenGLRenderer::CreateTexture(std::span<const uint8_t* const> levels, int width, int height, TextureFormat format, bool repeat) {
+    Renderer::TextureInfo info;
+    info.width = width;
+    info.height = height;
+    info.format = format;
+
+    GLuint glHandle;
+    glGenTextures(1, &glHandle);
+    m_glState.BindTexture(0, glHandle);
+
+    const GLint wrap = repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels.size() > 1 ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size()) - 1);
+
+    if (format == TextureFormat::R || format == TextureFormat::RG) {
+        const GLint alpha = format == TextureFormat::RG ? GL_GREEN : GL_ONE;
+        const GLint swizzle[4] = {GL_RED, GL_RED, GL_RED, alpha};
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+
+    const GLenum glFormat = GetGLFormat(format);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    int levelWidth = width;
+    int levelHeight = height;
+    for (size_t level = 0; level < levels.size(); level++) {
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GetGLInternalFormat(format), levelWidth, levelHeight, 0,
+                     glFormat, GL_UNSIGNED_BYTE, levels[level]);
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    TextureHandle handle = NEXT_TEXTURE_HANDLE++;
+    m_textures[handle] = glHandle;
+    info.handle = handle;
+    m_textureInfos[handle] = info;
+    return info;
+}
+
+void OpenGLRenderer::UpdateTexture(TextureHandle handle, int x, int y, int width, int height, const uint8_t* pixels) {
+    auto it = m_textures.find(handle);
+    if (it == m_textures.end()) {
+        LOG_WARN("Texture update requested for invalid handle: " << handle);
+        return;
+    }
+
+    m_glState.BindTexture(0, it->second);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GetGLFormat(m_textureInfos[handle].format), GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
 Vec2i OpenGLRenderer::GetTextureSize(TextureHandle handle) const {
     auto it = m_textureInfos.find(handle);
     if (it != m_textureInfos.end()) {
@@ -583,70 +875,79 @@ Vec2i OpenGLRenderer::GetTextureSize(TextureHandle handle) const {
     return {0, 0};
 }
 
-void OpenGLRenderer::SetMaterial(Material material) { m_currentMaterial = material; }
+void OpenGLRenderer::SetMaterial(const Material& material) {
+    SubmitState& state = GetSubmitState();
+    state.shader = material.shader ? material.shader->GetHandle() : 0;
+    state.texture = material.texture ? material.texture->GetHandle() : 0;
+    state.blendMode = material.blendMode;
+    if (state.blendMode == BlendMode::NORMAL && material.texture && material.texture->IsPremultiplied()) {
+        state.blendMode = BlendMode::PREMULTIPLIED;
+    }
+    state.uniforms = material.HasUniforms() ? GetRecordQueue().AddUniforms(material) : RenderCommand::NO_UNIFORMS;
+}
 
-FontHandle OpenGLRenderer::CreateFont(const std::string_view path, int size) {
-    FT_Face face;
-    if (FT_New_Face(m_ftLibrary, path.data(), 0, &face)) {
-        LOG_ERROR("Failed to load font: " << path);
+FontHandle OpenGLRenderer::CreateFont(std::vector<uint8_t> data, int size) {
+    FontHandle handle = NEXT_FONT_HANDLE++;
+    if (!m_glyphAtlas.LoadFont(handle, std::move(data), size)) {
         return 0;
     }
+    return handle;
+}
 
-    FT_Set_Pixel_Sizes(face, 0, size);
-    
-    FontHandle handle = NEXT_FONT_HANDLE++;
-    std::unordered_map<char, Glyph> glyphs;
-    
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    
-    // Load ASCII characters
-    for (unsigned char c = 0; c < 128; c++) {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            LOG_WARN("Failed to load Glyph for character: " << (int)c);
-            continue;
-        }
+void OpenGLRenderer::UploadGlyphPages() {
+    for (size_t i = 0; i < m_glyphAtlas.GetPageCount(); i++) {
+        GlyphAtlas::Page& page = m_glyphAtlas.GetPage(i);
+        if (!page.dirty) continue;
 
-        Glyph glyph;
-        glyph.size = {static_cast<int>(face->glyph->bitmap.width), static_cast<int>(face->glyph->bitmap.rows)};
-        glyph.bearing = {face->glyph->bitmap_left, face->glyph->bitmap_top};
-        glyph.advance = face->glyph->advance.x;
-        
-        // Create texture only if glyph has bitmap data
-        if (glyph.size.x > 0 && glyph.size.y > 0) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        auto it = m_textures.find(page.texture);
+        if (it == m_textures.end()) {
             GLuint texture;
             glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-            
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RED,
-                        glyph.size.x, glyph.size.y, 0,
-                        GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
-            
+            m_glState.BindTexture(0, texture);
+
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, GlyphAtlas::PAGE_SIZE, GlyphAtlas::PAGE_SIZE, 0,
+                         GL_RED, GL_UNSIGNED_BYTE, page.pixels.data());
+
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            
-            glyph.texture = NEXT_TEXTURE_HANDLE++;
-            m_textures[glyph.texture] = texture;
+
+            m_textures[page.texture] = texture;
+
+            TextureInfo info;
+            info.handle = page.texture;
+            info.width = GlyphAtlas::PAGE_SIZE;
+            info.height = GlyphAtlas::PAGE_SIZE;
+            info.format = TextureFormat::R;
+            m_textureInfos[page.texture] = info;
+        } else {
+            // Only the rows and columns touched since the last upload
+            m_glState.BindTexture(0, it->second);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, GlyphAtlas::PAGE_SIZE);
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, page.dirtyMinX);
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, page.dirtyMinY);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, page.dirtyMinX, page.dirtyMinY,
+                            page.dirtyMaxX - page.dirtyMinX, page.dirtyMaxY - page.dirtyMinY,
+                            GL_RED, GL_UNSIGNED_BYTE, page.pixels.data());
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
         }
-        
-        glyphs[c] = glyph;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        page.dirty = false;
     }
-    
-    m_fonts[handle] = std::move(glyphs);
-    
-    FT_Done_Face(face);
-    return handle;
 }
 
 RenderTargetHandle OpenGLRenderer::CreateRenderTarget(int width, int height) {
     RenderTargetData data;
     glGenFramebuffers(1, &data.frameBuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, data.frameBuffer);
+    m_glState.BindFramebuffer(data.frameBuffer);
     
     GLuint textureId;
     glGenTextures(1, &textureId);
-    glBindTexture(GL_TEXTURE_2D, textureId);
+    m_glState.BindTexture(0, textureId);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -659,7 +960,7 @@ RenderTargetHandle OpenGLRenderer::CreateRenderTarget(int width, int height) {
         LOG_ERROR("Framebuffer is not complete!");
     }
     
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_glState.BindFramebuffer(0);
     
     TextureHandle texHandle = NEXT_TEXTURE_HANDLE++;
     m_textures[texHandle] = textureId;
@@ -681,75 +982,164 @@ RenderTargetHandle OpenGLRenderer::CreateRenderTarget(int width, int height) {
 }
 
 void OpenGLRenderer::SetRenderTarget(RenderTargetHandle handle) {
-    m_currentRenderTarget = handle;
+    GetSubmitState().renderTarget = handle;
 }
 
 void OpenGLRenderer::UseRenderTarget(RenderTargetHandle handle) {
-    SetRenderTarget(handle);
     if (handle != 0) {
         auto it = m_renderTargets.find(handle);
         if (it != m_renderTargets.end()) {
-            glBindFramebuffer(GL_FRAMEBUFFER, it->second.frameBuffer);
-            glViewport(0, 0, it->second.target.GetWidth(), it->second.target.GetHeight());
+            // Remember whatever framebuffer the caller had bound (e.g. the editor's game view)
+            // so switching back to target 0 returns there instead of the window
+            if (m_boundRenderTarget == 0) {
+                GLint framebuffer = 0;
+                glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+                m_screenFramebuffer = static_cast<GLuint>(framebuffer);
+            }
+            m_glState.BindFramebuffer(it->second.frameBuffer);
+            m_glState.Viewport(0, 0, it->second.target.GetWidth(), it->second.target.GetHeight());
         } else {
             LOG_WARN("Invalid render target handle: " << handle);
         }
     } else {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport(static_cast<GLsizei>(m_viewport.x), 
+        m_glState.BindFramebuffer(m_screenFramebuffer);
+        m_glState.Viewport(static_cast<GLsizei>(m_viewport.x), 
                 static_cast<GLsizei>(m_viewport.y), 
                 static_cast<GLsizei>(m_viewport.w), 
                 static_cast<GLsizei>(m_viewport.h));
     }
+    m_boundRenderTarget = handle;
 }
 
 void OpenGLRenderer::ClearRenderTarget() {
-    UseRenderTarget(0);
+    SetRenderTarget(0);
 }
 
-void OpenGLRenderer::AddRenderCommand(std::unique_ptr<RenderCommand> command) { m_renderCommands.push_back(std::move(command)); }
+void OpenGLRenderer::AddRenderCommand(const RenderCommand& command) {
+    RenderQueue& queue = GetRecordQueue();
+    queue.Push(command);
+    RenderCommand& queued = queue.Back();
+    queued.key = RenderCommand::MakeKey(queued.renderTarget, queued.depth, queued.shader, queued.texture);
+}
+
+void OpenGLRenderer::BeginBuckets(uint32_t count) {
+    if (m_buckets.size() < count) {
+        m_buckets.resize(count);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        RecordBucket& bucket = m_buckets[i];
+        bucket.queue.Clear();
+        bucket.state = m_submit;
+        // Uniform indices are per queue, so inherited uniform values are copied over
+        if (m_submit.uniforms != RenderCommand::NO_UNIFORMS) {
+            bucket.state.uniforms = bucket.queue.AddUniforms(m_renderQueue.GetUniforms(m_submit.uniforms));
+        }
+        bucket.hasProjection = false;
+    }
+    m_bucketCount = count;
+}
+
+void OpenGLRenderer::EndBuckets() {
+    CLEAVE_PROFILE_SCOPE("Renderer::EndBuckets");
+    for (uint32_t i = 0; i < m_bucketCount; i++) {
+        RecordBucket& bucket = m_buckets[i];
+        uint32_t uniformBase = m_renderQueue.Append(bucket.queue);
+        if (bucket.hasProjection) {
+            m_projection = bucket.projection;
+        }
+
+        // Whatever the last bucket left set carries on, as it would have sequentially
+        if (i + 1 == m_bucketCount) {
+            m_submit = bucket.state;
+            if (m_submit.uniforms != RenderCommand::NO_UNIFORMS) {
+                m_submit.uniforms += uniformBase;
+            }
+        }
+    }
+    m_bucketCount = 0;
+}
+
+void OpenGLRenderer::BeginBucket(uint32_t index) {
+    if (index >= m_bucketCount) {
+        LOG_ERROR("Invalid render bucket: " << index);
+        return;
+    }
+    s_recordBucket = &m_buckets[index];
+}
+
+void OpenGLRenderer::EndBucket() { s_recordBucket = nullptr; }
+
+OpenGLRenderer::SubmitState& OpenGLRenderer::GetSubmitState() {
+    return s_recordBucket ? s_recordBucket->state : m_submit;
+}
+
+const OpenGLRenderer::SubmitState& OpenGLRenderer::GetSubmitState() const {
+    return s_recordBucket ? s_recordBucket->state : m_submit;
+}
+
+RenderQueue& OpenGLRenderer::GetRecordQueue() {
+    return s_recordBucket ? s_recordBucket->queue : m_renderQueue;
+}
+
+RenderCommand OpenGLRenderer::MakeCommand(RenderCommand::Type type, Color color) const {
+    const SubmitState& state = GetSubmitState();
+    RenderCommand command;
+    command.type = type;
+    command.blendMode = state.blendMode;
+    command.depth = state.depth;
+    command.renderTarget = state.renderTarget;
+    command.shader = state.shader;
+    command.texture = state.texture;
+    command.uniforms = state.uniforms;
+    command.color = color;
+    // Tints are straight alpha, so they're brought in line with the premultiplied texture
+    if (command.blendMode == BlendMode::PREMULTIPLIED) {
+        command.color.r = static_cast<uint8_t>((color.r * color.a + 127) / 255);
+        command.color.g = static_cast<uint8_t>((color.g * color.a + 127) / 255);
+        command.color.b = static_cast<uint8_t>((color.b * color.a + 127) / 255);
+    }
+    if (!command.shader) {
+        command.shader = type == RenderCommand::Type::Quad ? m_defaultShader : m_defaultColorShader;
+    }
+    return command;
+}
 
 void OpenGLRenderer::ClearColor(Color color) {
     glClearColor(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
 }
 
 void OpenGLRenderer::DrawQuad(Rect4f rect, float u0, float v0, float u1, float v1, Color color) {
-    AddRenderCommand(
-        std::make_unique<RenderQuadCommand>(
-            rect, 1.0f, 1.0f, 
-            0.0f, m_currentMaterial,
-            m_depth, u0, v0, u1, v1, color, m_currentRenderTarget
-        )
-    );
+    DrawQuad(rect, 1.0f, 1.0f, 0.0f, u0, v0, u1, v1, color);
 }
 
 void OpenGLRenderer::DrawQuad(Rect4f rect, float scaleX, float scaleY, float rotation, float u0, float v0, float u1, float v1, Color color) {
-    AddRenderCommand(
-        std::make_unique<RenderQuadCommand>(
-            rect, scaleX, scaleY, 
-            rotation, m_currentMaterial, 
-            m_depth, u0, v0, u1, v1, color, m_currentRenderTarget
-        )
-    );
+    RenderCommand command = MakeCommand(RenderCommand::Type::Quad, color);
+    command.quad = {rect, scaleX, scaleY, rotation, u0, v0, u1, v1};
+    AddRenderCommand(command);
 }
 
-void OpenGLRenderer::DrawSprite(Transform transform, Material material) {
-    Vec2i size = GetTextureSize(material.texture->GetHandle());
+void OpenGLRenderer::DrawSprite(Transform transform, const Material& material) {
+    Vec2i size = {material.texture->GetWidth(), material.texture->GetHeight()};
+    Rect4f uv = material.texture->GetUVRect();
     SetMaterial(material);
     DrawQuad(
         Rect4f(transform.GetPosition().x, transform.GetPosition().y, static_cast<float>(size.x), static_cast<float>(size.y)),
         transform.GetScale().x, transform.GetScale().y, transform.GetRotation(),
-        0.0f, 0.0f, 1.0f, 1.0f, Color::White()
+        uv.x, uv.y, uv.x + uv.w, uv.y + uv.h, Color::White()
     );
     // LOG_INFO("Using material texture handle: " << material.texture->GetHandle());
 }
 
 void OpenGLRenderer::DrawLine(float x1, float y1, float x2, float y2, Color color) {
-    AddRenderCommand(std::make_unique<RenderLineCommand>(x1, y1, x2, y2, color, m_currentMaterial, m_depth, m_currentRenderTarget));
+    RenderCommand command = MakeCommand(RenderCommand::Type::Line, color);
+    command.line = {x1, y1, x2, y2};
+    AddRenderCommand(command);
 }
 
 void OpenGLRenderer::DrawRect(Rect4f rect, Color color) {
-    AddRenderCommand(std::make_unique<RenderRectCommand>(rect, color, m_currentMaterial, m_depth, m_currentRenderTarget));
+    RenderCommand command = MakeCommand(RenderCommand::Type::Rect, color);
+    command.rect = {rect};
+    AddRenderCommand(command);
 }
 
 void OpenGLRenderer::DrawRectOutline(Rect4f rect, Color color) {
@@ -760,41 +1150,36 @@ void OpenGLRenderer::DrawRectOutline(Rect4f rect, Color color) {
 }
 
 void OpenGLRenderer::DrawCircle(float x, float y, float radius, Color color, int segments) {
-    AddRenderCommand(std::make_unique<RenderCircleCommand>(x, y, radius, color, segments, m_currentMaterial, m_depth, m_currentRenderTarget));
+    RenderCommand command = MakeCommand(RenderCommand::Type::Circle, color);
+    command.circle = {x, y, radius, segments};
+    AddRenderCommand(command);
 }
 
-const Glyph* OpenGLRenderer::GetGlyph(FontHandle font, char c) {
-    auto fontIt = m_fonts.find(font);
-    if (fontIt == m_fonts.end())
-        return nullptr;
-
-    auto& glyphs = fontIt->second;
-    auto glyphIt = glyphs.find(c);
-    if (glyphIt == glyphs.end())
-        return nullptr;
-
-    return &glyphIt->second;
+const Glyph* OpenGLRenderer::GetGlyph(FontHandle font, uint32_t codepoint) {
+    std::lock_guard<std::mutex> lock(m_glyphMutex);
+    return m_glyphAtlas.GetGlyph(font, codepoint);
 }
 
 void OpenGLRenderer::DrawText(const std::string_view text, FontHandle font, float x, float y, float scale, Color color) {
-    const Glyph* glyph;
     float cursorX = x;
     float cursorY = y;
 
-    for (char c : text) {
-        glyph = GetGlyph(font, c);
-        if (!glyph || glyph->texture == -1) {
+    for (size_t i = 0; i < text.size();) {
+        const Glyph* glyph = GetGlyph(font, GlyphAtlas::DecodeUtf8(text, i));
+        if (!glyph) {
             cursorX += 8 * scale;
             continue;
         }
 
-        float xpos = cursorX + glyph->bearing.x * scale;
-        float ypos = cursorY - (glyph->size.y - glyph->bearing.y) * scale;
-        float w = glyph->size.x * scale;
-        float h = glyph->size.y * scale;
+        if (glyph->texture) {
+            float xpos = cursorX + glyph->bearing.x * scale;
+            float ypos = cursorY - (glyph->size.y - glyph->bearing.y) * scale;
+            float w = glyph->size.x * scale;
+            float h = glyph->size.y * scale;
 
-        SetTexture(glyph->texture);
-        DrawQuad(Rect4f(xpos, ypos, w, h), 0.0f, 0.0f, 1.0f, 1.0f, color); 
+            SetTexture(glyph->texture);
+            DrawQuad(Rect4f(xpos, ypos, w, h), glyph->u0, glyph->v0, glyph->u1, glyph->v1, color);
+        }
 
         cursorX += (glyph->advance >> 6) * scale;
     }
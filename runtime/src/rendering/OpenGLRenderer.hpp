@@ -1,10 +1,16 @@
 #pragma once
 #include "rendering/Renderer.hpp"
 #include "rendering/RenderTarget.hpp"
+#include "rendering/RenderQueue.hpp"
+#include "rendering/StreamBuffer.hpp"
+#include "rendering/GlyphAtlas.hpp"
+#include "rendering/GLStateCache.hpp"
+#include <chrono>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <GL/glew.h>
-#include <ft2build.h>
-#include FT_FREETYPE_H  
 #ifdef DrawText
 #undef DrawText
 #endif
@@ -17,17 +23,23 @@ namespace Cleave {
 class OpenGLRenderer : public Renderer {
 public:
     OpenGLRenderer()
-        : m_projection(Matrix4::Ortho(0.0f, 512.0f, 288.0f, 0.0f, -1.0f, 1.0f)),
+        : m_projection(GetDefaultProjection()),
           m_viewport(0.0f, 0.0f, 512.0f, 288.0f) {}
     ~OpenGLRenderer();
     void Initialize(Window& window);
     void Terminate();
 
+    // Also resets the projection, so one left over from the last frame never leaks into culling
     void BeginFrame();
     void EndFrame();
 
     uint32_t GetDrawCalls() const;
     uint32_t GetTextureSwaps() const;
+    uint32_t GetBatches() const;
+    uint32_t GetSkippedStateChanges() const;
+
+    bool IsInstancingEnabled() const;
+    void SetInstancingEnabled(bool enabled);
 
     int GetDepth() const;
     void SetDepth(int depth);
@@ -43,6 +55,10 @@ public:
 
     ShaderHandle CreateShader(const std::string_view vertex, const std::string_view fragment);
     void SetShader(ShaderHandle handle);
+    ShaderHandle GetDefaultShader() const;
+    void SetDefaultShader(ShaderHandle handle);
+    ShaderHandle GetDefaultColorShader() const;
+    void SetDefaultColorShader(ShaderHandle handle);
     void UseShader(ShaderHandle handle);
     void SetShaderUniformInt(const std::string_view name, int value) const;
     void SetShaderUniformFloat(const std::string_view name, float value) const;
@@ -50,30 +66,44 @@ public:
     void SetShaderUniformVector3f(const std::string_view name, float x, float y, float z) const;
     void SetShaderUniformVector4f(const std::string_view name, float x, float y, float z, float w) const;
     void SetShaderUniformMatrix4(const std::string_view name, Matrix4 matrix) const;
+    void SetShaderUniformInt(UniformId id, int value) const;
+    void SetShaderUniformFloat(UniformId id, float value) const;
+    void SetShaderUniformVector2f(UniformId id, float x, float y) const;
+    void SetShaderUniformVector3f(UniformId id, float x, float y, float z) const;
+    void SetShaderUniformVector4f(UniformId id, float x, float y, float z, float w) const;
+    void SetShaderUniformMatrix4(UniformId id, Matrix4 matrix) const;
 
     void SetTexture(TextureHandle handle);
     void UseTexture(TextureHandle handle);
     Renderer::TextureInfo CreateFallbackTexture();
     Renderer::TextureInfo CreateTexture(const std::string_view path);
+    Renderer::TextureInfo CreateTexture(const uint8_t* pixels, int width, int height, TextureFormat format, bool repeat = false);
+    Renderer::TextureInfo CreateTexture(std::span<const uint8_t* const> levels, int width, int height, TextureFormat format, bool repeat = false);
+    void UpdateTexture(TextureHandle handle, int x, int y, int width, int height, const uint8_t* pixels);
     Vec2i GetTextureSize(TextureHandle handle) const;
     
-    void SetMaterial(Material material);
+    void SetMaterial(const Material& material);
 
-    FontHandle CreateFont(const std::string_view path, int size);
+    FontHandle CreateFont(std::vector<uint8_t> data, int size);
 
     RenderTargetHandle CreateRenderTarget(int width, int height);
     void SetRenderTarget(RenderTargetHandle handle);
     void UseRenderTarget(RenderTargetHandle handle);
     void ClearRenderTarget();
 
-    void AddRenderCommand(std::unique_ptr<RenderCommand> command);
+    void AddRenderCommand(const RenderCommand& command);
+
+    void BeginBuckets(uint32_t count);
+    void EndBuckets();
+    void BeginBucket(uint32_t index);
+    void EndBucket();
 
     void ClearColor(Color color);
 
     void DrawQuad(Rect4f rect,
                   float u0 = 0.0f, float v0 = 0.0f, float u1 = 1.0f, float v1 = 1.0f, Color color = Color::White());
     void DrawQuad(Rect4f rect, float scaleX = 1.0f, float scaleY = 1.0f, float rotation = 0.0f, float u0 = 0.0f, float v0 = 0.0f, float u1 = 1.0f, float v1 = 1.0f, Color color = Color::White());
-    void DrawSprite(Transform transform, Material material);
+    void DrawSprite(Transform transform, const Material& material);
 
     void DrawLine(float x1, float y1, float x2, float y2, Color color);
     void DrawRect(Rect4f rect, Color color);
@@ -81,36 +111,158 @@ public:
     void DrawCircle(float x, float y, float radius, Color color, int segments = 16);
     void DrawText(const std::string_view text, FontHandle font, float x, float y, float scale, Color color);
 
-    const Glyph* GetGlyph(FontHandle font, char c);
+    const Glyph* GetGlyph(FontHandle font, uint32_t codepoint);
 private:
-    void ApplyMaterialUniforms(const Material& material) const;
+    static Matrix4 GetDefaultProjection();
+    void ApplyMaterialUniforms(const UniformValues& values) const;
+
+    // One sprite in an instanced batch: the columns of a 2x3 affine, the UV rect and the tint
+    struct SpriteInstance {
+        float axisX[2];
+        float axisY[2];
+        float origin[2];
+        float u0, v0, u1, v1;
+        uint8_t r, g, b, a;
+    };
+
+    struct BatchVertex {
+        float x, y;
+        float u, v;
+        uint8_t r, g, b, a;
+    };
+
+    struct ColorVertex {
+        float x, y;
+        uint8_t r, g, b, a;
+    };
+
+    enum class BatchKind : uint8_t {
+        Quads,
+        Instances,
+        Lines,
+        Triangles
+    };
+
+    // State shared by every quad in a batch; a change in any of these forces a flush
+    struct BatchState {
+        RenderTargetHandle renderTarget = 0;
+        ShaderHandle shader = 0;
+        TextureHandle texture = 0;
+        BlendMode blendMode = BlendMode::NORMAL;
+        uint32_t uniforms = RenderCommand::NO_UNIFORMS;
+        BatchKind kind = BatchKind::Quads;
+
+        bool operator==(const BatchState& other) const = default;
+    };
+
+    // Draw state captured into submitted commands
+    struct SubmitState {
+        TextureHandle texture = 0;
+        ShaderHandle shader = 0;
+        BlendMode blendMode = BlendMode::NORMAL;
+        uint32_t uniforms = RenderCommand::NO_UNIFORMS;
+        RenderTargetHandle renderTarget = 0;
+        int depth = 0;
+    };
+
+    // Commands recorded by one worker; starts from the submit state current at BeginBuckets
+    struct RecordBucket {
+        RenderQueue queue;
+        SubmitState state;
+        bool hasProjection = false;
+        Matrix4 projection;
+    };
+
+    // Uniform locations are reflected once at link time and indexed by UniformId
+    struct ShaderProgram {
+        GLuint program = 0;
+        std::vector<GLint> uniformLocations;
+        mutable std::unordered_set<UniformId> warnedUniforms;
+    };
+
+    // std140 layout of the FrameData block shared by every program
+    struct FrameUniforms {
+        float projection[16];
+        float viewport[4];
+        float time;
+        float padding[3];
+    };
+    static_assert(sizeof(FrameUniforms) == 96, "FrameUniforms must match the std140 FrameData block");
+    static constexpr GLuint FRAME_UNIFORM_BINDING = 0;
+
+    bool BuildProgram(const std::string_view vertex, const std::string_view fragment, ShaderProgram& program);
+    void BindProgram(ShaderHandle handle, const ShaderProgram& program);
+    GLint GetUniformLocation(UniformId id) const;
+    void UploadFrameUniforms();
+    void UploadGlyphPages();
+
+    SubmitState& GetSubmitState();
+    const SubmitState& GetSubmitState() const;
+    RenderQueue& GetRecordQueue();
+
+    RenderCommand MakeCommand(RenderCommand::Type type, Color color) const;
+    void PushQuad(const RenderCommand& command);
+    void PushPrimitive(const RenderCommand& command);
+    const std::vector<Vec2f>& GetCircleTable(int segments);
+    void FlushBatch();
+
+    static constexpr uint32_t MAX_BATCH_QUADS = 4096;
+    static constexpr uint32_t MAX_BATCH_INSTANCES = 16384;
+    static constexpr size_t MAX_BATCH_COLOR_VERTICES = 65536;
+    static constexpr int MAX_CIRCLE_SEGMENTS = 1024;
+    static constexpr size_t STREAM_REGION_SIZE = 4 * 1024 * 1024;
+    static constexpr uint32_t MAX_GLYPH_PAGES = 4;
     struct RenderTargetData {
         RenderTarget target;
         GLuint frameBuffer = 0;
     };
 
-    std::unordered_map<ShaderHandle, GLuint> m_shaders;
+    std::unordered_map<ShaderHandle, ShaderProgram> m_shaders;
+    std::unordered_map<ShaderHandle, ShaderProgram> m_instancedShaders;
     std::unordered_map<TextureHandle, GLuint> m_textures;
     std::unordered_map<TextureHandle, TextureInfo> m_textureInfos;
-    std::unordered_map<FontHandle, std::unordered_map<char, Glyph>> m_fonts;
     std::unordered_map<RenderTargetHandle, RenderTargetData> m_renderTargets;
-    std::vector<std::unique_ptr<RenderCommand>> m_renderCommands;
-    int m_depth = 0;
+    RenderQueue m_renderQueue;
     Matrix4 m_projection;
     Rect4f m_viewport;
     BlendMode m_blendMode = BlendMode::NORMAL;
 
     uint32_t m_drawCalls = 0;
     uint32_t m_textureSwaps = 0;
+    uint32_t m_batches = 0;
+
+    GlyphAtlas m_glyphAtlas;
+    std::mutex m_glyphMutex;  // Workers recording text share the atlas
+
+    SubmitState m_submit;
+    ShaderHandle m_defaultShader = 0;  // Used by quads submitted without a shader
+    ShaderHandle m_defaultColorShader = 0;  // Used by lines, rects and circles submitted without a shader
+
+    std::vector<RecordBucket> m_buckets;
+    uint32_t m_bucketCount = 0;
+    static thread_local RecordBucket* s_recordBucket;
+
+    // What is actually bound in GL while EndFrame submits
+    GLStateCache m_glState;
+    ShaderHandle m_boundShader = 0;
+    const ShaderProgram* m_boundProgram = nullptr;
+    RenderTargetHandle m_boundRenderTarget = 0;
+    GLuint m_screenFramebuffer = 0;
+    GLuint m_frameUniformBuffer = 0;
+    std::chrono::steady_clock::time_point m_startTime;
+    StreamBuffer m_stream;
+    GLuint m_batchVAO = 0;
+    GLuint m_batchEBO = 0;
+    std::vector<BatchVertex> m_batchVertices;
+    BatchState m_batchState;
 
-    FT_Library m_ftLibrary;
+    bool m_instancingEnabled = true;
+    GLuint m_instanceVAO = 0;
+    GLuint m_unitQuadVBO = 0;
+    std::vector<SpriteInstance> m_instances;
 
-    Material m_currentMaterial;
-    TextureHandle m_currentTexture = 0;
-    ShaderHandle m_currentShader = 0;
-    RenderTargetHandle m_currentRenderTarget = -1;
-    GLuint m_quadVAO = 0;
-    GLuint m_quadVBO = 0;
-    GLuint m_quadEBO = 0;
+    GLuint m_colorVAO = 0;
+    std::vector<ColorVertex> m_colorVertices;
+    std::unordered_map<int, std::vector<Vec2f>> m_circleTables;
 };
 }
\ No newline at end of file
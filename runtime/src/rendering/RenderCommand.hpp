@@ -1,95 +1,74 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
 #include "rendering/TextureHandle.hpp"
 #include "rendering/ShaderHandle.hpp"
 #include "rendering/RenderTargetHandle.hpp"
-#include "rendering/FontHandle.hpp"
 #include "rendering/BlendMode.hpp"
 #include "rendering/Color.hpp"
-#include "rendering/Material.hpp"
 #include "math/Rect4.hpp"
 
 namespace Cleave {
+// Plain-data draw record. Commands are copied by value into the per-frame RenderQueue
+// and ordered by `key`, so nothing here may own memory.
 struct RenderCommand {
-    enum class Type {
+    enum class Type : uint8_t {
         Rect,
         Quad,
         Line,
-        Circle,
-        Glyph
-    } type;
-    int depth = 0;
-    Material material;
-    RenderTargetHandle renderTarget = 0;
-    RenderCommand(int _depth, Material _material, RenderTargetHandle _renderTarget) : depth(_depth), material(_material), renderTarget(_renderTarget) {}
-};
+        Circle
+    };
 
-struct RenderQuadCommand : RenderCommand {
-    Rect4f rect;
-    float scaleX, scaleY, rotation;
-    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
-    Color color = Color::White();
-
-    RenderQuadCommand(Rect4f _rect,
-            float _scaleX = 1.0f, float _scaleY = 1.0f, float _rotation = 0.0f, 
-            Material _material = Material(), 
-            int _depth = 0, 
-            float _u0 = 0.0f, float _v0 = 0.0f, 
-            float _u1 = 1.0f, float _v1 = 1.0f,
-            Color _color = Color::White(),
-            RenderTargetHandle _renderTarget = 0
-        )
-            : RenderCommand(_depth, _material, _renderTarget), rect(_rect), 
-            scaleX(_scaleX), scaleY(_scaleY), rotation(_rotation),
-            u0(_u0), v0(_v0), u1(_u1), v1(_v1), color(_color) {
-            type = Type::Quad;
-        }
-};
+    struct QuadData {
+        Rect4f rect;
+        float scaleX, scaleY, rotation;
+        float u0, v0, u1, v1;
+    };
 
-struct RenderGlyphCommand : public RenderCommand {
-    FontHandle font;
-    char character;
-    float x, y;
-    float scale;
-    Color color;
+    struct LineData {
+        float x1, y1, x2, y2;
+    };
 
-    RenderGlyphCommand(FontHandle _font, char _character, float _x, float _y, float _scale, Color _color, Material _material, int _depth, RenderTargetHandle _renderTarget = 0)
-        : RenderCommand(_depth, _material, _renderTarget), font(_font), character(_character), x(_x), y(_y), scale(_scale), color(_color) {
-            type = Type::Glyph;
-        }
-};
+    struct RectData {
+        Rect4f rect;
+    };
 
+    struct CircleData {
+        float x, y, radius;
+        int segments;
+    };
 
-struct RenderLineCommand : RenderCommand {
-    float x1, y1, x2, y2;
-    Color color;
+    static constexpr uint32_t NO_UNIFORMS = UINT32_MAX;
 
-    RenderLineCommand(float _x1, float _y1, float _x2, float _y2, Color _color, 
-                     Material _material, int _depth = 0, RenderTargetHandle _renderTarget = 0)
-        : RenderCommand(_depth, _material, _renderTarget), x1(_x1), y1(_y1), x2(_x2), y2(_y2), color(_color) {
-            type = Type::Line;
-        }
-};
+    uint64_t key = 0;
+    Type type = Type::Quad;
+    BlendMode blendMode = BlendMode::NORMAL;
+    int depth = 0;
+    RenderTargetHandle renderTarget = 0;
+    ShaderHandle shader = 0;
+    TextureHandle texture = 0;
+    uint32_t uniforms = NO_UNIFORMS;  // Index into the queue's material table
+    Color color = Color::White();
+    union {
+        QuadData quad;
+        LineData line;
+        RectData rect;
+        CircleData circle;
+    };
 
-struct RenderRectCommand : RenderCommand {
-    Rect4f rect;
-    Color color;
+    RenderCommand() : quad() {}
 
-    RenderRectCommand(Rect4f _rect, Color _color, 
-                     Material _material, int _depth = 0, RenderTargetHandle _renderTarget = 0)
-        : RenderCommand(_depth, _material, _renderTarget), rect(_rect), color(_color) {
-            type = Type::Rect;
-        }
+    // Bits 63-56 render target, 55-40 depth, 39-24 shader, 23-0 texture
+    static uint64_t MakeKey(RenderTargetHandle renderTarget, int depth, ShaderHandle shader, TextureHandle texture) {
+        uint64_t biasedDepth = static_cast<uint64_t>(std::clamp(depth, -32768, 32767) + 32768);
+        return (static_cast<uint64_t>(renderTarget & 0xFF) << 56) |
+               (biasedDepth << 40) |
+               (static_cast<uint64_t>(shader & 0xFFFF) << 24) |
+               static_cast<uint64_t>(texture & 0xFFFFFF);
+    }
 };
 
-struct RenderCircleCommand : RenderCommand {
-    float x, y, radius;
-    Color color;
-    int segments;
-
-    RenderCircleCommand(float _x, float _y, float _radius, Color _color, int _segments = 16, 
-                     Material _material = Material(), int _depth = 0, RenderTargetHandle _renderTarget = 0)
-        : RenderCommand(_depth, _material, _renderTarget), x(_x), y(_y), radius(_radius), color(_color), segments(_segments) {
-            type = Type::Circle;
-        }
-};
-} // namespace Cleave
\ No newline at end of file
+static_assert(std::is_trivially_copyable_v<RenderCommand>, "RenderCommand must stay plain data");
+} // namespace Cleave
@@ -0,0 +1,112 @@
+#include "rendering/RenderQueue.hpp"
+
+#include <utility>
+
+namespace Cleave {
+void RenderQueue::Clear() {
+    m_commands.clear();
+    m_uniformBlocks.clear();
+    m_intUniforms.clear();
+    m_floatUniforms.clear();
+    m_vec2fUniforms.clear();
+    m_matrix4Uniforms.clear();
+    m_order.clear();
+}
+
+void RenderQueue::Reserve(size_t count) {
+    m_commands.reserve(count);
+    m_order.reserve(count);
+    m_scratch.reserve(count);
+}
+
+void RenderQueue::Push(const RenderCommand& command) { m_commands.push_back(command); }
+RenderCommand& RenderQueue::Back() { return m_commands.back(); }
+
+uint32_t RenderQueue::Append(const RenderQueue& other) {
+    const uint32_t uniformBase = static_cast<uint32_t>(m_uniformBlocks.size());
+    for (uint32_t i = 0; i < other.m_uniformBlocks.size(); i++) {
+        AddUniforms(other.GetUniforms(i));
+    }
+
+    const size_t first = m_commands.size();
+    m_commands.insert(m_commands.end(), other.m_commands.begin(), other.m_commands.end());
+    if (uniformBase != 0 && !other.m_uniformBlocks.empty()) {
+        for (size_t i = first; i < m_commands.size(); i++) {
+            if (m_commands[i].uniforms != RenderCommand::NO_UNIFORMS) {
+                m_commands[i].uniforms += uniformBase;
+            }
+        }
+    }
+    return uniformBase;
+}
+
+template <typename Value, typename Source>
+RenderQueue::UniformRange RenderQueue::AddValues(std::vector<Value>& arena, const Source& values) {
+    const uint32_t first = static_cast<uint32_t>(arena.size());
+    arena.insert(arena.end(), values.begin(), values.end());
+    return {first, static_cast<uint32_t>(arena.size()) - first};
+}
+
+uint32_t RenderQueue::AddUniforms(const Material& material) {
+    m_uniformBlocks.push_back({AddValues(m_intUniforms, material.intUniforms),
+                               AddValues(m_floatUniforms, material.floatUniforms),
+                               AddValues(m_vec2fUniforms, material.vec2fUniforms),
+                               AddValues(m_matrix4Uniforms, material.matrix4Uniforms)});
+    return static_cast<uint32_t>(m_uniformBlocks.size() - 1);
+}
+
+uint32_t RenderQueue::AddUniforms(const UniformValues& values) {
+    m_uniformBlocks.push_back({AddValues(m_intUniforms, values.ints), AddValues(m_floatUniforms, values.floats),
+                               AddValues(m_vec2fUniforms, values.vec2fs), AddValues(m_matrix4Uniforms, values.matrix4s)});
+    return static_cast<uint32_t>(m_uniformBlocks.size() - 1);
+}
+
+UniformValues RenderQueue::GetUniforms(uint32_t index) const {
+    const UniformBlock& block = m_uniformBlocks[index];
+    return {std::span(m_intUniforms).subspan(block.ints.first, block.ints.count),
+            std::span(m_floatUniforms).subspan(block.floats.first, block.floats.count),
+            std::span(m_vec2fUniforms).subspan(block.vec2fs.first, block.vec2fs.count),
+            std::span(m_matrix4Uniforms).subspan(block.matrix4s.first, block.matrix4s.count)};
+}
+
+void RenderQueue::Sort() {
+    const size_t count = m_commands.size();
+    m_order.resize(count);
+    m_scratch.resize(count);
+    if (count == 0) return;
+
+    uint32_t histograms[8][256] = {};
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = m_commands[i].key;
+        m_order[i] = {key, static_cast<uint32_t>(i)};
+        for (int pass = 0; pass < 8; pass++) {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    for (int pass = 0; pass < 8; pass++) {
+        const int shift = pass * 8;
+        uint32_t* histogram = histograms[pass];
+
+        // Every key shares this byte, so the pass wouldn't move anything
+        if (histogram[(m_order[0].key >> shift) & 0xFF] == count) continue;
+
+        uint32_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            uint32_t bucketSize = histogram[digit];
+            histogram[digit] = offset;
+            offset += bucketSize;
+        }
+
+        for (const SortEntry& entry : m_order) {
+            m_scratch[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        std::swap(m_order, m_scratch);
+    }
+}
+
+size_t RenderQueue::GetSize() const { return m_commands.size(); }
+bool RenderQueue::IsEmpty() const { return m_commands.empty(); }
+
+const RenderCommand& RenderQueue::GetSorted(size_t i) const { return m_commands[m_order[i].index]; }
+}  // namespace Cleave
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "rendering/RenderCommand.hpp"
+#include "rendering/Material.hpp"
+
+namespace Cleave {
+// The custom uniforms of one SetMaterial call, viewing the arena of the queue holding them
+struct UniformValues {
+    std::span<const std::pair<UniformId, int>> ints;
+    std::span<const std::pair<UniformId, float>> floats;
+    std::span<const std::pair<UniformId, Vec2f>> vec2fs;
+    std::span<const std::pair<UniformId, Matrix4>> matrix4s;
+};
+
+// Linear per-frame command storage. Clear() keeps every buffer's capacity, so once the
+// queue has grown to a scene's size, submitting a draw doesn't touch the heap.
+class RenderQueue {
+public:
+    void Clear();
+    void Reserve(size_t count);
+
+    void Push(const RenderCommand& command);
+    RenderCommand& Back();
+
+    // Appends another queue's commands after this one's, rebasing their uniform indices.
+    // Returns the offset added to those indices.
+    uint32_t Append(const RenderQueue& other);
+
+    // Custom uniform values are copied into flat per-frame arrays once per SetMaterial call,
+    // the returned index is what commands store in RenderCommand::uniforms
+    uint32_t AddUniforms(const Material& material);
+    uint32_t AddUniforms(const UniformValues& values);
+    // Valid until the queue is cleared or more uniforms are added
+    UniformValues GetUniforms(uint32_t index) const;
+
+    // Stable LSD radix sort on RenderCommand::key
+    void Sort();
+
+    size_t GetSize() const;
+    bool IsEmpty() const;
+
+    // Valid after Sort(), returns the i-th command in key order
+    const RenderCommand& GetSorted(size_t i) const;
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    struct UniformRange {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+    struct UniformBlock {
+        UniformRange ints, floats, vec2fs, matrix4s;
+    };
+
+    template <typename Value, typename Source>
+    static UniformRange AddValues(std::vector<Value>& arena, const Source& values);
+
+    std::vector<RenderCommand> m_commands;
+    std::vector<UniformBlock> m_uniformBlocks;
+    std::vector<std::pair<UniformId, int>> m_intUniforms;
+    std::vector<std::pair<UniformId, float>> m_floatUniforms;
+    std::vector<std::pair<UniformId, Vec2f>> m_vec2fUniforms;
+    std::vector<std::pair<UniformId, Matrix4>> m_matrix4Uniforms;
+    std::vector<SortEntry> m_order;
+    std::vector<SortEntry> m_scratch;
+};
+}  // namespace Cleave
@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include "rendering/Color.hpp"
 #include "rendering/TextureFormat.hpp"
@@ -10,6 +12,7 @@
 #include "rendering/RenderTargetHandle.hpp"
 #include "rendering/BlendMode.hpp"
 #include "rendering/RenderCommand.hpp"
+#include "rendering/UniformId.hpp"
 #include "math/Matrix4.hpp"
 #include "math/Transform.hpp"
 #include "math/Rect4.hpp"
@@ -26,10 +29,11 @@ struct Material;
 class Window;
 
 struct Glyph {
-    TextureHandle texture;
+    TextureHandle texture = 0;    // Atlas page the glyph lives on
     Vec2i size;       // Size of glyph
     Vec2i bearing;    // Offset from baseline to left/top of glyph
-    unsigned int advance;    // Offset to advance to next glyph
+    unsigned int advance = 0;    // Offset to advance to next glyph
+    float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;    // Rect inside the page
 
     Glyph() : size(0, 0), bearing(0, 0) {}
     Glyph(TextureHandle tex, Vec2i sz, Vec2i bear, unsigned int adv) 
@@ -48,6 +52,11 @@ public:
 
     virtual uint32_t GetDrawCalls() const = 0;
     virtual uint32_t GetTextureSwaps() const = 0;
+    virtual uint32_t GetBatches() const = 0;
+    virtual uint32_t GetSkippedStateChanges() const = 0;
+
+    virtual bool IsInstancingEnabled() const = 0;
+    virtual void SetInstancingEnabled(bool enabled) = 0;
 
     virtual int GetDepth() const = 0;
     virtual void SetDepth(int depth) = 0;
@@ -63,6 +72,10 @@ public:
 
     virtual ShaderHandle CreateShader(const std::string_view vertex, const std::string_view fragment) = 0;
     virtual void SetShader(ShaderHandle handle) = 0;
+    virtual ShaderHandle GetDefaultShader() const = 0;
+    virtual void SetDefaultShader(ShaderHandle handle) = 0;
+    virtual ShaderHandle GetDefaultColorShader() const = 0;
+    virtual void SetDefaultColorShader(ShaderHandle handle) = 0;
     virtual void UseShader(ShaderHandle shader) = 0;
     virtual void SetShaderUniformInt(const std::string_view name, int value) const = 0;
     virtual void SetShaderUniformFloat(const std::string_view name, float value) const = 0;
@@ -70,6 +83,12 @@ public:
     virtual void SetShaderUniformVector3f(const std::string_view name, float x, float y, float z) const = 0;
     virtual void SetShaderUniformVector4f(const std::string_view name, float x, float y, float z, float w) const = 0;
     virtual void SetShaderUniformMatrix4(const std::string_view name, Matrix4 matrix) const = 0;
+    virtual void SetShaderUniformInt(UniformId id, int value) const = 0;
+    virtual void SetShaderUniformFloat(UniformId id, float value) const = 0;
+    virtual void SetShaderUniformVector2f(UniformId id, float x, float y) const = 0;
+    virtual void SetShaderUniformVector3f(UniformId id, float x, float y, float z) const = 0;
+    virtual void SetShaderUniformVector4f(UniformId id, float x, float y, float z, float w) const = 0;
+    virtual void SetShaderUniformMatrix4(UniformId id, Matrix4 matrix) const = 0;
 
     struct TextureInfo {
         TextureHandle handle = 0;
@@ -79,27 +98,44 @@ public:
     };
     virtual TextureInfo CreateFallbackTexture() = 0;
     virtual TextureInfo CreateTexture(const std::string_view path) = 0;
+    // Clamps at the edges unless `repeat` is set, which file textures use so UVs past 1 tile.
+    // Textures packed into the TextureAtlas clamp regardless.
+    virtual TextureInfo CreateTexture(const uint8_t* pixels, int width, int height, TextureFormat format, bool repeat = false) = 0;
+    // `levels` is a mip chain, each level half the size of the one before down to 1x1. R and RG
+    // textures read as grey and grey with alpha.
+    virtual TextureInfo CreateTexture(std::span<const uint8_t* const> levels, int width, int height, TextureFormat format, bool repeat = false) = 0;
+    virtual void UpdateTexture(TextureHandle handle, int x, int y, int width, int height, const uint8_t* pixels) = 0;
     virtual void SetTexture(TextureHandle handle) = 0;
     virtual void UseTexture(TextureHandle texture) = 0;
     virtual Vec2i GetTextureSize(TextureHandle handle) const = 0;
 
-    virtual void SetMaterial(Material material) = 0;
+    virtual void SetMaterial(const Material& material) = 0;
 
-    virtual FontHandle CreateFont(const std::string_view path, int size = 48) = 0;
+    // Takes the font file's bytes, which have to stay around as long as the font
+    virtual FontHandle CreateFont(std::vector<uint8_t> data, int size = 48) = 0;
 
     virtual RenderTargetHandle CreateRenderTarget(int width, int height) = 0;
     virtual void SetRenderTarget(RenderTargetHandle handle) = 0;
     virtual void UseRenderTarget(RenderTargetHandle handle) = 0;
     virtual void ClearRenderTarget() = 0;
 
-    virtual void AddRenderCommand(std::unique_ptr<RenderCommand> command) = 0;
+    virtual void AddRenderCommand(const RenderCommand& command) = 0;
+
+    // Parallel recording. The GL thread opens `count` buckets, worker threads bind one with
+    // BeginBucket and issue Set*/Draw* calls into it, and EndBuckets appends them in index
+    // order once every worker is done. Giving buckets consecutive slices of the work keeps
+    // the frame identical to recording it on one thread.
+    virtual void BeginBuckets(uint32_t count) = 0;
+    virtual void EndBuckets() = 0;
+    virtual void BeginBucket(uint32_t index) = 0;
+    virtual void EndBucket() = 0;
 
     virtual void ClearColor(Color color) = 0;
 
     virtual void DrawQuad(Rect4f rect, float u0 = 0.0f, float v0 = 0.0f, float u1 = 1.0f, float v1 = 1.0f, Color color = Color::White()) = 0;
     virtual void DrawQuad(Rect4f rect, float scaleX = 1.0f, float scaleY = 1.0f, float rotation = 0.0f, float u0 = 0.0f, float v0 = 0.0f, float u1 = 1.0f, float v1 = 1.0f, Color color = Color::White()) = 0;
 
-    virtual void DrawSprite(Transform transform, Material material) = 0;
+    virtual void DrawSprite(Transform transform, const Material& material) = 0;
     
     virtual void DrawLine(float x1, float y1, float x2, float y2, Color color) = 0;
     virtual void DrawRect(Rect4f rect, Color color) = 0;
@@ -107,6 +143,6 @@ public:
     virtual void DrawCircle(float x, float y, float radius, Color color, int segments = 16) = 0;
     virtual void DrawText(const std::string_view text, FontHandle font, float x, float y, float scale, Color color) = 0;
 
-    virtual const Glyph* GetGlyph(FontHandle font, char c) = 0;
+    virtual const Glyph* GetGlyph(FontHandle font, uint32_t codepoint) = 0;
 };
 }  // namespace Cleave
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "rendering/ShelfPacker.hpp"
+
+namespace Cleave {
+// New shelves are rounded up to this so rects of nearby heights can share them
+constexpr int SHELF_HEIGHT_STEP = 8;
+
+ShelfPacker::ShelfPacker(int width, int height, int padding)
+    : m_width(width), m_height(height), m_padding(padding) {}
+
+int ShelfPacker::Pack(int width, int height, Vec2i& position) {
+    const int paddedWidth = width + m_padding;
+    const int paddedHeight = height + m_padding;
+    if (paddedWidth > m_width || paddedHeight > m_height) return -1;
+
+    int best = -1;
+    int bestWaste = 0;
+    for (int i = 0; i < static_cast<int>(m_shelves.size()); i++) {
+        const Shelf& shelf = m_shelves[i];
+        if (shelf.height < paddedHeight || shelf.cursor + paddedWidth > m_width) continue;
+
+        int waste = shelf.height - paddedHeight;
+        if (best == -1 || waste < bestWaste) {
+            best = i;
+            bestWaste = waste;
+        }
+    }
+
+    // Open a new shelf rather than burying a short rect on a much taller one
+    const int shelfHeight = (paddedHeight + SHELF_HEIGHT_STEP - 1) / SHELF_HEIGHT_STEP * SHELF_HEIGHT_STEP;
+    if ((best == -1 || bestWaste > paddedHeight / 2) && m_nextY + shelfHeight <= m_height) {
+        m_shelves.push_back({m_nextY, shelfHeight, 0});
+        m_nextY += shelfHeight;
+        best = static_cast<int>(m_shelves.size()) - 1;
+    }
+
+    if (best == -1) return -1;
+
+    Shelf& shelf = m_shelves[best];
+    position = {shelf.cursor, shelf.y};
+    shelf.cursor += paddedWidth;
+    return best;
+}
+
+void ShelfPacker::ClearShelf(int shelf) { m_shelves[shelf].cursor = 0; }
+
+void ShelfPacker::Clear() {
+    m_shelves.clear();
+    m_nextY = 0;
+}
+
+int ShelfPacker::GetShelfCount() const { return static_cast<int>(m_shelves.size()); }
+int ShelfPacker::GetShelfY(int shelf) const { return m_shelves[shelf].y; }
+int ShelfPacker::GetShelfHeight(int shelf) const { return m_shelves[shelf].height; }
+int ShelfPacker::GetUsedHeight() const { return m_nextY; }
+int ShelfPacker::GetWidth() const { return m_width; }
+int ShelfPacker::GetHeight() const { return m_height; }
+}  // namespace Cleave
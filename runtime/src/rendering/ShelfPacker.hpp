@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+
+#include "math/Vec2.hpp"
+
+namespace Cleave {
+// Packs rectangles into horizontal shelves. Shelves keep their position and height for
+// the packer's lifetime, so a cleared shelf can be refilled with rects of similar height.
+class ShelfPacker {
+public:
+    ShelfPacker(int width, int height, int padding = 1);
+
+    // Places a width x height rect and returns the shelf it went on, or -1 if there is no room
+    int Pack(int width, int height, Vec2i& position);
+    void ClearShelf(int shelf);
+    void Clear();
+
+    int GetShelfCount() const;
+    int GetShelfY(int shelf) const;
+    int GetShelfHeight(int shelf) const;
+    int GetUsedHeight() const;
+    int GetWidth() const;
+    int GetHeight() const;
+
+private:
+    struct Shelf {
+        int y = 0;
+        int height = 0;
+        int cursor = 0;
+    };
+
+    std::vector<Shelf> m_shelves;
+    int m_width;
+    int m_height;
+    int m_padding;
+    int m_nextY = 0;
+};
+}  // namespace Cleave
@@ -0,0 +1,98 @@
+#include "rendering/StreamBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Log.hpp"
+
+namespace Cleave {
+void StreamBuffer::Create(size_t regionSize, GLStateCache* state) {
+    m_state = state;
+    m_regionSize = regionSize;
+    glGenBuffers(1, &m_buffer);
+    m_state->BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    glBufferData(GL_ARRAY_BUFFER, m_regionSize * FRAME_REGIONS, nullptr, GL_STREAM_DRAW);
+    m_region = 0;
+    m_head = 0;
+    m_regionEnd = m_regionSize;
+}
+
+void StreamBuffer::Destroy() {
+    for (GLsync& fence : m_fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+}
+
+void StreamBuffer::BeginFrame() {
+    m_region = (m_region + 1) % FRAME_REGIONS;
+    m_head = m_region * m_regionSize;
+    m_regionEnd = m_head + m_regionSize;
+
+    GLsync& fence = m_fences[m_region];
+    if (fence) {
+        // Normally already signalled; only blocks if the GPU is more than two frames behind
+        GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+            LOG_WARN("Stream buffer fence wait failed, orphaning");
+            m_state->BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+            glBufferData(GL_ARRAY_BUFFER, m_regionSize * FRAME_REGIONS, nullptr, GL_STREAM_DRAW);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+void StreamBuffer::EndFrame() {
+    if (m_fences[m_region]) {
+        glDeleteSync(m_fences[m_region]);
+    }
+    m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+size_t StreamBuffer::Write(const void* data, size_t size, size_t stride) {
+    size_t offset = (m_head + stride - 1) / stride * stride;
+
+    m_state->BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    if (offset + size > m_regionEnd) {
+        // A write that can't fit any region grows them all, which the reallocation below applies
+        if (size > m_regionSize) {
+            const size_t grown = std::max(size, m_regionSize * 2);
+            LOG_WARN("Stream buffer write of " << size << " bytes exceeds region size " << m_regionSize
+                                               << ", growing regions to " << grown);
+            m_regionSize = grown;
+        }
+
+        // Out of room for this frame: give the driver fresh storage and start over. Every
+        // fence refers to the old storage, so none of them need waiting on anymore.
+        glBufferData(GL_ARRAY_BUFFER, m_regionSize * FRAME_REGIONS, nullptr, GL_STREAM_DRAW);
+        for (GLsync& fence : m_fences) {
+            if (fence) {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        m_region = 0;
+        m_regionEnd = m_regionSize;
+        offset = 0;
+    }
+
+    void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (mapped) {
+        std::memcpy(mapped, data, size);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }
+
+    m_head = offset + size;
+    return offset;
+}
+
+GLuint StreamBuffer::GetBuffer() const { return m_buffer; }
+}  // namespace Cleave
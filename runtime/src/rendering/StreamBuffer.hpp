@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <GL/glew.h>
+
+#include "rendering/GLStateCache.hpp"
+
+namespace Cleave {
+// Persistent vertex buffer split into per-frame regions. Each frame appends into its own
+// region and fences it at the end; a region is only rewritten once the GPU has passed its
+// fence, so writes can map unsynchronized. If a frame outgrows its region the buffer is
+// orphaned and writing restarts from the beginning; a single write larger than a whole
+// region grows the regions first.
+class StreamBuffer {
+public:
+    static constexpr uint32_t FRAME_REGIONS = 3;
+
+    // Buffer binds go through `state` so the renderer's cache stays in sync
+    void Create(size_t regionSize, GLStateCache* state);
+    void Destroy();
+
+    void BeginFrame();
+    void EndFrame();
+
+    // Appends `size` bytes and returns their offset. The offset is a multiple of `stride`
+    // so callers can address the data as vertex or instance indices.
+    size_t Write(const void* data, size_t size, size_t stride);
+
+    GLuint GetBuffer() const;
+
+private:
+    GLStateCache* m_state = nullptr;
+    GLuint m_buffer = 0;
+    size_t m_regionSize = 0;
+    uint32_t m_region = 0;
+    size_t m_head = 0;
+    size_t m_regionEnd = 0;
+    GLsync m_fences[FRAME_REGIONS] = {};
+};
+}  // namespace Cleave
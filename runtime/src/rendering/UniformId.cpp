@@ -0,0 +1,56 @@
+#include "rendering/UniformId.hpp"
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace Cleave {
+namespace {
+struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+};
+
+struct UniformRegistry {
+    // Names are registered once at shader link time and looked up per call after that, so
+    // lookups only share the lock
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, UniformId, NameHash, std::equal_to<>> ids;
+    std::deque<std::string> names;
+};
+
+UniformRegistry& GetRegistry() {
+    static UniformRegistry registry;
+    return registry;
+}
+}  // namespace
+
+UniformId GetUniformId(std::string_view name) {
+    UniformRegistry& registry = GetRegistry();
+    {
+        std::shared_lock lock(registry.mutex);
+        auto it = registry.ids.find(name);
+        if (it != registry.ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(registry.mutex);
+    auto it = registry.ids.find(name);
+    if (it != registry.ids.end()) {
+        return it->second;
+    }
+    UniformId id = static_cast<UniformId>(registry.names.size());
+    registry.names.emplace_back(name);
+    registry.ids.emplace(registry.names.back(), id);
+    return id;
+}
+
+const std::string& GetUniformName(UniformId id) {
+    UniformRegistry& registry = GetRegistry();
+    std::shared_lock lock(registry.mutex);
+    return registry.names.at(id);
+}
+}  // namespace Cleave
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Cleave {
+typedef uint32_t UniformId;
+
+// Interns a uniform name. Ids are small and dense so shaders can index their location tables with them.
+UniformId GetUniformId(std::string_view name);
+const std::string& GetUniformName(UniformId id);
+}  // namespace Cleave
@@ -0,0 +1,169 @@
+#include "resources/CookedTexture.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Cleave {
+namespace {
+constexpr char MAGIC[4] = {'C', 'T', 'E', 'X'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t FLAG_PREMULTIPLIED = 1 << 0;
+constexpr uint32_t MAX_LEVELS = 32;
+
+// Everything is stored in the machine's native (little endian) byte order
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;  // TextureFormat
+    uint32_t levelCount;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+struct LevelEntry {
+    uint64_t offset;  // From the start of the file
+    uint64_t size;
+};
+
+size_t GetBytesPerPixel(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R: return 1;
+        case TextureFormat::RG: return 2;
+        case TextureFormat::RGB: return 3;
+        default: return 4;
+    }
+}
+
+// Halves an RGBA8 level with a box filter. Odd edges reuse their last row or column.
+std::vector<uint8_t> Downsample(const std::vector<uint8_t>& source, int width, int height) {
+    const int nextWidth = std::max(width / 2, 1);
+    const int nextHeight = std::max(height / 2, 1);
+    std::vector<uint8_t> dest(static_cast<size_t>(nextWidth) * nextHeight * 4);
+    for (int y = 0; y < nextHeight; y++) {
+        const int y0 = std::min(y * 2, height - 1);
+        const int y1 = std::min(y * 2 + 1, height - 1);
+        for (int x = 0; x < nextWidth; x++) {
+            const int x0 = std::min(x * 2, width - 1);
+            const int x1 = std::min(x * 2 + 1, width - 1);
+            for (int channel = 0; channel < 4; channel++) {
+                auto at = [&](int sx, int sy) { return source[(static_cast<size_t>(sy) * width + sx) * 4 + channel]; };
+                const int sum = at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1);
+                dest[(static_cast<size_t>(y) * nextWidth + x) * 4 + channel] = static_cast<uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return dest;
+}
+}  // namespace
+
+bool CookedTexture::Open(std::span<const uint8_t> data) {
+    m_levels.clear();
+    FileHeader header;
+    if (data.size() < sizeof(FileHeader)) return false;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.width == 0 || header.height == 0 || header.width > INT32_MAX || header.height > INT32_MAX ||
+        header.format > static_cast<uint32_t>(TextureFormat::RG) ||
+        header.levelCount == 0 || header.levelCount > MAX_LEVELS ||
+        data.size() - sizeof(FileHeader) < header.levelCount * sizeof(LevelEntry)) {
+        return false;
+    }
+
+    m_data = data;
+    m_width = static_cast<int>(header.width);
+    m_height = static_cast<int>(header.height);
+    m_format = static_cast<TextureFormat>(header.format);
+    m_premultiplied = header.flags & FLAG_PREMULTIPLIED;
+
+    uint64_t width = header.width;
+    uint64_t height = header.height;
+    for (uint32_t i = 0; i < header.levelCount; i++) {
+        LevelEntry entry;
+        std::memcpy(&entry, data.data() + sizeof(FileHeader) + i * sizeof(LevelEntry), sizeof(entry));
+        if (entry.size != width * height * GetBytesPerPixel(m_format) ||
+            entry.offset > data.size() || entry.size > data.size() - entry.offset) {
+            m_levels.clear();
+            return false;
+        }
+        m_levels.push_back(data.subspan(entry.offset, entry.size));
+        width = std::max<uint64_t>(width / 2, 1);
+        height = std::max<uint64_t>(height / 2, 1);
+    }
+    return true;
+}
+
+int CookedTexture::GetWidth() const { return m_width; }
+int CookedTexture::GetHeight() const { return m_height; }
+TextureFormat CookedTexture::GetFormat() const { return m_format; }
+bool CookedTexture::IsPremultiplied() const { return m_premultiplied; }
+
+uint32_t CookedTexture::GetLevelCount() const { return static_cast<uint32_t>(m_levels.size()); }
+std::span<const uint8_t> CookedTexture::GetLevel(uint32_t level) const { return m_levels[level]; }
+
+std::vector<uint8_t> TextureCooker::Cook(const uint8_t* pixels, int width, int height, bool mipmaps) {
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> level(pixels, pixels + pixelCount * 4);
+
+    // Filtering premultiplied color keeps transparent texels from bleeding into their neighbours
+    bool grey = true;
+    bool opaque = true;
+    for (size_t i = 0; i < pixelCount; i++) {
+        uint8_t* pixel = &level[i * 4];
+        grey = grey && pixel[0] == pixel[1] && pixel[1] == pixel[2];
+        opaque = opaque && pixel[3] == 255;
+        for (int channel = 0; channel < 3; channel++) {
+            pixel[channel] = static_cast<uint8_t>((pixel[channel] * pixel[3] + 127) / 255);
+        }
+    }
+    const TextureFormat format = grey ? (opaque ? TextureFormat::R : TextureFormat::RG) : TextureFormat::RGBA;
+    const size_t bytesPerPixel = GetBytesPerPixel(format);
+
+    // R8 keeps the grey value, RG8 grey and alpha
+    std::vector<std::vector<uint8_t>> levels;
+    int levelWidth = width;
+    int levelHeight = height;
+    while (true) {
+        const size_t levelPixels = static_cast<size_t>(levelWidth) * levelHeight;
+        std::vector<uint8_t>& packed = levels.emplace_back(levelPixels * bytesPerPixel);
+        for (size_t i = 0; i < levelPixels; i++) {
+            packed[i * bytesPerPixel] = level[i * 4];
+            if (format == TextureFormat::RG) {
+                packed[i * 2 + 1] = level[i * 4 + 3];
+            } else if (format == TextureFormat::RGBA) {
+                std::copy_n(&level[i * 4 + 1], 3, &packed[i * 4 + 1]);
+            }
+        }
+
+        if (!mipmaps || (levelWidth == 1 && levelHeight == 1)) break;
+        level = Downsample(level, levelWidth, levelHeight);
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.format = static_cast<uint32_t>(format);
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.flags = FLAG_PREMULTIPLIED;
+
+    std::vector<LevelEntry> entries(levels.size());
+    uint64_t offset = sizeof(FileHeader) + entries.size() * sizeof(LevelEntry);
+    for (size_t i = 0; i < levels.size(); i++) {
+        entries[i] = {offset, levels[i].size()};
+        offset += levels[i].size();
+    }
+
+    std::vector<uint8_t> file(offset);
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + sizeof(FileHeader), entries.data(), entries.size() * sizeof(LevelEntry));
+    for (size_t i = 0; i < levels.size(); i++) {
+        std::copy(levels[i].begin(), levels[i].end(), file.begin() + entries[i].offset);
+    }
+    return file;
+}
+}  // namespace Cleave
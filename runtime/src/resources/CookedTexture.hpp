@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "rendering/TextureFormat.hpp"
+
+namespace Cleave {
+// .ctex files: an image cooked offline into the layout it is uploaded in. A header, a table
+// of mip levels and the tightly packed pixels of each level, largest first. Color is
+// premultiplied by alpha, and grey images are stored as R8 or RG8.
+class CookedTexture {
+public:
+    // Appended to the source image's path, e.g. "res/textures/cat.png.ctex"
+    static constexpr const char* EXTENSION = ".ctex";
+
+    // Keeps pointing into `data`, which has to outlive the view
+    bool Open(std::span<const uint8_t> data);
+
+    int GetWidth() const;
+    int GetHeight() const;
+    TextureFormat GetFormat() const;
+    bool IsPremultiplied() const;
+
+    uint32_t GetLevelCount() const;
+    std::span<const uint8_t> GetLevel(uint32_t level) const;
+
+private:
+    std::span<const uint8_t> m_data;
+    int m_width = 0;
+    int m_height = 0;
+    TextureFormat m_format = TextureFormat::RGBA;
+    bool m_premultiplied = false;
+    std::vector<std::span<const uint8_t>> m_levels;
+};
+
+class TextureCooker {
+public:
+    // Cooks width x height RGBA8 pixels into the contents of a .ctex file
+    static std::vector<uint8_t> Cook(const uint8_t* pixels, int width, int height, bool mipmaps);
+};
+}  // namespace Cleave
@@ -6,27 +6,39 @@
 
 namespace Cleave {
 std::shared_ptr<Resource> FontLoader::Load(const std::string& path, ResourceManager* resourceManager) {
-    auto fontPath = std::filesystem::path(path);
+    return Prepare(path, resourceManager)();
+}
 
-    auto renderer = resourceManager->GetRenderer();
-    if (!renderer) {
-        LOG_ERROR("No renderer available");
-        return nullptr;
+ResourceLoader::Completion FontLoader::Prepare(const std::string& path, ResourceManager* resourceManager) {
+    ResourceData data;
+    if (!resourceManager->ReadResource(path, data)) {
+        LOG_ERROR("Failed to read font: " << path);
+        return [] { return nullptr; };
     }
 
-    std::shared_ptr<Font> font = std::make_shared<Font>();
-    font->SetPath(path);
-    
-    int size = 48;
-    FontHandle handle = renderer->CreateFont(path, size);
-    if (handle == 0) {
-        LOG_ERROR("Failed to create font: " << path);
-        return nullptr;
-    }
-    
-    font->SetHandle(handle);
-    font->SetSize(size);
-    
-    return font;
+    // FreeType keeps reading the face, so the renderer gets its own copy of the bytes
+    std::vector<uint8_t> bytes(data.GetBytes().begin(), data.GetBytes().end());
+    return [path, resourceManager, bytes = std::move(bytes)]() mutable -> std::shared_ptr<Resource> {
+        auto renderer = resourceManager->GetRenderer();
+        if (!renderer) {
+            LOG_ERROR("No renderer available");
+            return nullptr;
+        }
+
+        std::shared_ptr<Font> font = std::make_shared<Font>();
+        font->SetPath(path);
+
+        int size = 48;
+        FontHandle handle = renderer->CreateFont(std::move(bytes), size);
+        if (handle == 0) {
+            LOG_ERROR("Failed to create font: " << path);
+            return nullptr;
+        }
+
+        font->SetHandle(handle);
+        font->SetSize(size);
+
+        return font;
+    };
 }
 } // namespace Cleave
@@ -13,7 +13,8 @@ public:
     Font() {}
     ~Font() = default;
 
-    std::string_view GetTypeName() const override { return "cleave::Font"; }
+    static constexpr std::string_view TYPE_NAME = "cleave::Font";
+    std::string_view GetTypeName() const override { return TYPE_NAME; }
     FontHandle GetHandle() const { return m_handle; }
     void SetHandle(FontHandle handle) { m_handle = handle; }
     
@@ -26,7 +27,10 @@ private:
 
 class FontLoader : public ResourceLoader {
     std::shared_ptr<Resource> Load(const std::string& path, ResourceManager* resourceManager) override;
+    // Reads the font file; the completion creates the face
+    Completion Prepare(const std::string& path, ResourceManager* resourceManager) override;
 
+    std::string_view GetResourceTypeName() const override { return Font::TYPE_NAME; }
     bool CanLoad(const std::string_view extension) const override {
         return extension == ".ttf" || extension == ".otf";
     }
@@ -0,0 +1,134 @@
+#include "resources/Lz4.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Cleave {
+namespace {
+constexpr size_t MIN_MATCH = 4;
+// The format requires the last 5 bytes to be literals and the last match to start 12 bytes before the end
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MATCH_FIND_LIMIT = 12;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr uint32_t HASH_BITS = 16;
+constexpr uint32_t NO_POSITION = UINT32_MAX;
+
+uint32_t Read32(const uint8_t* source) {
+    uint32_t value;
+    std::memcpy(&value, source, sizeof(value));
+    return value;
+}
+
+uint32_t Hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); }
+
+// Lengths that don't fit their 4 bit field continue in bytes of 255 and a final remainder
+void WriteLength(std::vector<uint8_t>& dest, size_t length) {
+    for (; length >= 255; length -= 255) {
+        dest.push_back(255);
+    }
+    dest.push_back(static_cast<uint8_t>(length));
+}
+
+bool ReadLength(std::span<const uint8_t> source, size_t& in, size_t& length) {
+    uint8_t byte;
+    do {
+        if (in >= source.size()) return false;
+        byte = source[in++];
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+void WriteSequence(std::vector<uint8_t>& dest, const uint8_t* literals, size_t literalCount, size_t offset, size_t matchLength) {
+    const size_t matchCode = matchLength - MIN_MATCH;
+    dest.push_back(static_cast<uint8_t>((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalCount >= 15) {
+        WriteLength(dest, literalCount - 15);
+    }
+    dest.insert(dest.end(), literals, literals + literalCount);
+    dest.push_back(static_cast<uint8_t>(offset));
+    dest.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15) {
+        WriteLength(dest, matchCode - 15);
+    }
+}
+}  // namespace
+
+std::vector<uint8_t> Lz4Compress(std::span<const uint8_t> source) {
+    const uint8_t* data = source.data();
+    const size_t size = source.size();
+
+    std::vector<uint8_t> dest;
+    dest.reserve(size + size / 255 + 16);
+
+    size_t anchor = 0;
+    if (size > MATCH_FIND_LIMIT) {
+        std::vector<uint32_t> table(size_t(1) << HASH_BITS, NO_POSITION);
+        const size_t matchEnd = size - LAST_LITERALS;
+        size_t position = 0;
+        while (position + MATCH_FIND_LIMIT < size) {
+            const uint32_t sequence = Read32(data + position);
+            uint32_t& slot = table[Hash(sequence)];
+            const uint32_t candidate = slot;
+            slot = static_cast<uint32_t>(position);
+
+            if (candidate == NO_POSITION || position - candidate > MAX_OFFSET || Read32(data + candidate) != sequence) {
+                position++;
+                continue;
+            }
+
+            size_t length = MIN_MATCH;
+            while (position + length < matchEnd && data[candidate + length] == data[position + length]) {
+                length++;
+            }
+            WriteSequence(dest, data + anchor, position - anchor, position - candidate, length);
+            position += length;
+            anchor = position;
+        }
+    }
+
+    // The block ends on a sequence of literals only
+    const size_t literalCount = size - anchor;
+    dest.push_back(static_cast<uint8_t>(std::min<size_t>(literalCount, 15) << 4));
+    if (literalCount >= 15) {
+        WriteLength(dest, literalCount - 15);
+    }
+    dest.insert(dest.end(), data + anchor, data + size);
+    return dest;
+}
+
+bool Lz4Decompress(std::span<const uint8_t> source, std::span<uint8_t> dest) {
+    size_t in = 0;
+    size_t out = 0;
+    while (in < source.size()) {
+        const uint8_t token = source[in++];
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !ReadLength(source, in, literalCount)) return false;
+        if (literalCount > source.size() - in || literalCount > dest.size() - out) return false;
+        std::copy_n(source.begin() + in, literalCount, dest.begin() + out);
+        in += literalCount;
+        out += literalCount;
+
+        if (in == source.size()) break;
+
+        if (source.size() - in < 2) return false;
+        const size_t offset = source[in] | (source[in + 1] << 8);
+        in += 2;
+        if (offset == 0 || offset > out) return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(source, in, matchLength)) return false;
+        matchLength += MIN_MATCH;
+        if (matchLength > dest.size() - out) return false;
+
+        // Matches may overlap what they produce, so this copies byte by byte
+        const uint8_t* match = dest.data() + out - offset;
+        for (size_t i = 0; i < matchLength; i++) {
+            dest[out + i] = match[i];
+        }
+        out += matchLength;
+    }
+    return out == dest.size();
+}
+}  // namespace Cleave
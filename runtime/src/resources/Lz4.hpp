@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Cleave {
+// LZ4 block format, without the frame around it. Compression is a single greedy pass with a
+// hash table of recent positions; decompression checks every length and offset against both
+// buffers, so corrupt input fails instead of reading or writing out of bounds.
+std::vector<uint8_t> Lz4Compress(std::span<const uint8_t> source);
+// `dest` has to be exactly the uncompressed size
+bool Lz4Decompress(std::span<const uint8_t> source, std::span<uint8_t> dest);
+}  // namespace Cleave
@@ -0,0 +1,196 @@
+#include "resources/PackArchive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "Log.hpp"
+#include "profiling/Profiler.hpp"
+#include "resources/Lz4.hpp"
+
+namespace Cleave {
+namespace {
+constexpr char MAGIC[4] = {'C', 'P', 'A', 'K'};
+constexpr uint32_t VERSION = 1;
+
+// Everything is stored in the machine's native (little endian) byte order
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t entriesOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+uint64_t Align(uint64_t offset) {
+    return (offset + PackArchive::DATA_ALIGNMENT - 1) & ~uint64_t(PackArchive::DATA_ALIGNMENT - 1);
+}
+}  // namespace
+
+bool PackArchive::Open(const std::string_view path) {
+    Close();
+    if (!m_file.Open(path)) {
+        LOG_ERROR("Failed to open: " << path);
+        return false;
+    }
+
+    const uint8_t* data = m_file.GetData();
+    const size_t size = m_file.GetSize();
+    auto inFile = [size](uint64_t offset, uint64_t bytes) { return offset <= size && bytes <= size - offset; };
+
+    FileHeader header;
+    if (size < sizeof(FileHeader)) {
+        LOG_ERROR("Invalid pack archive: " << path);
+        Close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.entriesOffset % alignof(Entry) != 0 ||
+        !inFile(header.entriesOffset, uint64_t(header.entryCount) * sizeof(Entry)) ||
+        !inFile(header.namesOffset, header.namesSize)) {
+        LOG_ERROR("Invalid pack archive: " << path);
+        Close();
+        return false;
+    }
+
+    m_entries = {reinterpret_cast<const Entry*>(data + header.entriesOffset), header.entryCount};
+    m_names = {reinterpret_cast<const char*>(data + header.namesOffset), header.namesSize};
+    for (const Entry& entry : m_entries) {
+        if (uint64_t(entry.nameOffset) + entry.nameLength > m_names.size() || !inFile(entry.offset, entry.storedSize) ||
+            entry.compression > static_cast<uint32_t>(Compression::Lz4) ||
+            (entry.compression == static_cast<uint32_t>(Compression::None) && entry.storedSize != entry.size)) {
+            LOG_ERROR("Invalid pack archive: " << path);
+            Close();
+            return false;
+        }
+    }
+    LOG_INFO("Mounted " << m_entries.size() << " entries from " << path);
+    return true;
+}
+
+void PackArchive::Close() {
+    m_file.Close();
+    m_entries = {};
+    m_names = {};
+}
+
+bool PackArchive::IsOpen() const { return m_file.IsOpen(); }
+
+std::span<const PackArchive::Entry> PackArchive::GetEntries() const { return m_entries; }
+
+std::string_view PackArchive::GetName(const Entry& entry) const {
+    return m_names.substr(entry.nameOffset, entry.nameLength);
+}
+
+const PackArchive::Entry* PackArchive::Find(const std::string_view name) const {
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), name,
+                               [this](const Entry& entry, const std::string_view value) { return GetName(entry) < value; });
+    if (it == m_entries.end() || GetName(*it) != name) return nullptr;
+    return &*it;
+}
+
+bool PackArchive::Read(const Entry& entry, ResourceData& data) const {
+    const std::span<const uint8_t> stored(m_file.GetData() + entry.offset, entry.storedSize);
+    if (entry.compression == static_cast<uint32_t>(Compression::None)) {
+        data = ResourceData(stored);
+        return true;
+    }
+
+    CLEAVE_PROFILE_SCOPE("PackArchive::Decompress");
+    std::vector<uint8_t> buffer(entry.size);
+    if (!Lz4Decompress(stored, buffer)) {
+        LOG_ERROR("Corrupt pack entry: " << GetName(entry));
+        return false;
+    }
+    data = ResourceData(std::move(buffer));
+    return true;
+}
+
+void PackWriter::Add(const std::string& name, std::vector<uint8_t> data, bool compress) {
+    PendingEntry entry;
+    entry.name = name;
+    entry.size = data.size();
+    if (compress) {
+        std::vector<uint8_t> compressed = Lz4Compress(data);
+        if (compressed.size() + data.size() / 16 < data.size()) {
+            data = std::move(compressed);
+            entry.compression = PackArchive::Compression::Lz4;
+        }
+    }
+    entry.data = std::move(data);
+    m_entries.push_back(std::move(entry));
+}
+
+bool PackWriter::Write(const std::string_view path) const {
+    // Sorted by name, so lookups can binary search the index in place
+    std::vector<const PendingEntry*> sorted;
+    sorted.reserve(m_entries.size());
+    for (const PendingEntry& entry : m_entries) {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const PendingEntry* a, const PendingEntry* b) { return a->name < b->name; });
+
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entryCount = static_cast<uint32_t>(sorted.size());
+
+    std::string names;
+    std::vector<PackArchive::Entry> entries(sorted.size());
+    for (size_t i = 0; i < sorted.size(); i++) {
+        entries[i] = {};
+        entries[i].nameOffset = static_cast<uint32_t>(names.size());
+        entries[i].nameLength = static_cast<uint32_t>(sorted[i]->name.size());
+        entries[i].size = sorted[i]->size;
+        entries[i].storedSize = sorted[i]->data.size();
+        entries[i].compression = static_cast<uint32_t>(sorted[i]->compression);
+        names += sorted[i]->name;
+    }
+
+    header.entriesOffset = Align(sizeof(FileHeader));
+    header.namesOffset = header.entriesOffset + entries.size() * sizeof(PackArchive::Entry);
+    header.namesSize = names.size();
+    uint64_t offset = Align(header.namesOffset + names.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        entries[i].offset = offset;
+        offset = Align(offset + entries[i].storedSize);
+    }
+
+    std::vector<uint8_t> file(offset, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + header.entriesOffset, entries.data(), entries.size() * sizeof(PackArchive::Entry));
+    std::memcpy(file.data() + header.namesOffset, names.data(), names.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        std::copy(sorted[i]->data.begin(), sorted[i]->data.end(), file.begin() + entries[i].offset);
+    }
+
+    std::ofstream out(std::string(path), std::ios::binary);
+    if (!out.is_open()) {
+        LOG_ERROR("Failed to open: " << path);
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return out.good();
+}
+
+size_t PackWriter::GetEntryCount() const { return m_entries.size(); }
+
+uint64_t PackWriter::GetSize() const {
+    uint64_t size = 0;
+    for (const PendingEntry& entry : m_entries) {
+        size += entry.size;
+    }
+    return size;
+}
+
+uint64_t PackWriter::GetStoredSize() const {
+    uint64_t size = 0;
+    for (const PendingEntry& entry : m_entries) {
+        size += entry.data.size();
+    }
+    return size;
+}
+}  // namespace Cleave
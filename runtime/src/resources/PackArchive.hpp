@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "platform/MappedFile.hpp"
+#include "resources/ResourceData.hpp"
+
+namespace Cleave {
+// .pak archives: every resource file in one mapped file. An index sorted by name points at
+// data blocks aligned to DATA_ALIGNMENT, each stored as is or LZ4 compressed. Stored entries
+// are handed out as spans into the mapping, so reading them copies nothing.
+class PackArchive {
+public:
+    static constexpr uint32_t DATA_ALIGNMENT = 16;
+
+    enum class Compression : uint32_t {
+        None,
+        Lz4,
+    };
+
+    struct Entry {
+        uint32_t nameOffset;  // Into the name data
+        uint32_t nameLength;
+        uint64_t offset;      // Of the data block, from the start of the file
+        uint64_t size;        // Once decompressed
+        uint64_t storedSize;
+        uint32_t compression; // Compression
+        uint32_t reserved;
+    };
+
+    bool Open(const std::string_view path);
+    void Close();
+    bool IsOpen() const;
+
+    std::span<const Entry> GetEntries() const;
+    std::string_view GetName(const Entry& entry) const;
+    const Entry* Find(const std::string_view name) const;
+
+    // Fails if the entry doesn't decompress to its recorded size
+    bool Read(const Entry& entry, ResourceData& data) const;
+
+private:
+    MappedFile m_file;
+    std::span<const Entry> m_entries;
+    std::string_view m_names;
+};
+
+// Builds a .pak file in memory and writes it out in one go
+class PackWriter {
+public:
+    // Entries are compressed when that saves at least 1/16 of their size
+    void Add(const std::string& name, std::vector<uint8_t> data, bool compress = true);
+    bool Write(const std::string_view path) const;
+
+    size_t GetEntryCount() const;
+    uint64_t GetSize() const;
+    uint64_t GetStoredSize() const;
+
+private:
+    struct PendingEntry {
+        std::string name;
+        std::vector<uint8_t> data;
+        uint64_t size = 0;
+        PackArchive::Compression compression = PackArchive::Compression::None;
+    };
+
+    std::vector<PendingEntry> m_entries;
+};
+}  // namespace Cleave
@@ -6,4 +6,8 @@ void Resource::SetId(const uint32_t id) { m_id = id; }
 
 const std::string& Resource::GetPath() const { return m_path; }
 void Resource::SetPath(const std::string& path) { m_path = path; }
+
+ResourceLoader::Completion ResourceLoader::Prepare(const std::string& path, ResourceManager* resourceManager) {
+    return [this, path, resourceManager] { return Load(path, resourceManager); };
+}
 }  // namespace Cleave
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -9,6 +10,7 @@ class Resource {
 public:
     virtual ~Resource() = default;
 
+    // Resource types also define a static TYPE_NAME returning the same, for lookups by type
     virtual std::string_view GetTypeName() const = 0;
 
     const std::string& GetPath() const;
@@ -24,9 +26,18 @@ protected:
 
 class ResourceLoader {
 public:
+    // Finishes a prepared resource on the thread that owns the GL context
+    using Completion = std::function<std::shared_ptr<Resource>()>;
+
     virtual ~ResourceLoader() = default;
     virtual std::shared_ptr<Resource> Load(const std::string& path, ResourceManager* resourceManager) = 0;
+    // Called from worker threads while resources are scanned. Does the file I/O and decoding
+    // that needs no GL context and leaves the rest to the returned completion. By default the
+    // whole Load runs in the completion.
+    virtual Completion Prepare(const std::string& path, ResourceManager* resourceManager);
     virtual bool CanLoad(const std::string_view extension) const = 0;
+    // Type name of the resources this loader creates, recorded in the manifest
+    virtual std::string_view GetResourceTypeName() const = 0;
 };
 
 }  // namespace Cleave
\ No newline at end of file
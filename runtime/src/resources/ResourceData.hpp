@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Cleave {
+// The bytes of one resource file. Points straight into a mapped pack archive, or owns a
+// buffer holding a loose file or a decompressed entry.
+class ResourceData {
+public:
+    ResourceData() = default;
+    explicit ResourceData(std::span<const uint8_t> mapped) : m_bytes(mapped) {}
+    explicit ResourceData(std::vector<uint8_t> buffer) : m_buffer(std::move(buffer)), m_bytes(m_buffer) {}
+
+    ResourceData(const ResourceData& other) = delete;
+    ResourceData& operator=(const ResourceData& other) = delete;
+    // Moving a vector keeps its heap buffer, so the span stays valid
+    ResourceData(ResourceData&& other) = default;
+    ResourceData& operator=(ResourceData&& other) = default;
+
+    std::span<const uint8_t> GetBytes() const { return m_bytes; }
+    std::string_view GetText() const { return {reinterpret_cast<const char*>(m_bytes.data()), m_bytes.size()}; }
+    size_t GetSize() const { return m_bytes.size(); }
+
+private:
+    std::vector<uint8_t> m_buffer;
+    std::span<const uint8_t> m_bytes;
+};
+}  // namespace Cleave
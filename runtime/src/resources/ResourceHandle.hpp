@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#include "resources/Resource.hpp"
+
+namespace Cleave {
+// One entry of the resource manager's slot table. The generation changes whenever the
+// slot's resource is replaced or unloaded, which invalidates every handle taken before.
+struct ResourceSlot {
+    std::shared_ptr<Resource> resource;
+    uint32_t generation = 0;
+};
+
+// The resource manager's slots, in fixed-size pages under a fixed page table. A slot never
+// moves once it's added, so handles can be dereferenced on worker threads while the main
+// thread adds resources.
+class ResourceSlotTable {
+public:
+    static constexpr uint32_t PAGE_SIZE = 256;
+    static constexpr uint32_t MAX_PAGES = 1024;
+
+    ResourceSlot& operator[](uint32_t index) { return m_pages[index / PAGE_SIZE][index % PAGE_SIZE]; }
+    const ResourceSlot& operator[](uint32_t index) const { return m_pages[index / PAGE_SIZE][index % PAGE_SIZE]; }
+
+    uint32_t GetSize() const { return m_size; }
+
+    // Main thread only. Returns the index of the new, empty slot.
+    uint32_t Add() {
+        if (m_size % PAGE_SIZE == 0) {
+            if (m_size / PAGE_SIZE == MAX_PAGES) {
+                throw std::runtime_error("Resource slot table is full");
+            }
+            m_pages[m_size / PAGE_SIZE] = std::make_unique<ResourceSlot[]>(PAGE_SIZE);
+        }
+        return m_size++;
+    }
+
+private:
+    std::array<std::unique_ptr<ResourceSlot[]>, MAX_PAGES> m_pages;
+    uint32_t m_size = 0;
+};
+
+// A resolved reference to a resource of type T. Dereferencing is an index and a generation
+// compare, with no name lookup, so entities can keep handles and use them every frame.
+// Handles come from ResourceManager::GetHandle, which checks the type once.
+template <typename T>
+class ResourceHandle {
+public:
+    ResourceHandle() = default;
+
+    // Null for default constructed handles and once the resource was unloaded or replaced
+    T* Get() const {
+        if (!m_slots) return nullptr;
+        const ResourceSlot& slot = (*m_slots)[m_index];
+        return slot.generation == m_generation ? static_cast<T*>(slot.resource.get()) : nullptr;
+    }
+
+    T* operator->() const { return Get(); }
+    explicit operator bool() const { return Get() != nullptr; }
+
+private:
+    friend class ResourceManager;
+    ResourceHandle(const ResourceSlotTable* slots, uint32_t index, uint32_t generation)
+        : m_slots(slots), m_index(index), m_generation(generation) {}
+
+    const ResourceSlotTable* m_slots = nullptr;
+    uint32_t m_index = 0;
+    uint32_t m_generation = 0;
+};
+}  // namespace Cleave
@@ -12,7 +12,8 @@ public:
     Shader() {}
     ~Shader() = default;
 
-    std::string_view GetTypeName() const override { return "cleave::Shader"; }
+    static constexpr std::string_view TYPE_NAME = "cleave::Shader";
+    std::string_view GetTypeName() const override { return TYPE_NAME; }
 
     ShaderHandle GetHandle() const;
     void SetHandle(ShaderHandle handle);
@@ -23,11 +24,15 @@ private:
 class ShaderLoader : public ResourceLoader {
 public:
     std::shared_ptr<Resource> Load(const std::string& path, ResourceManager* resourceManager) override;
+    // Reads both stages; the completion compiles them
+    Completion Prepare(const std::string& path, ResourceManager* resourceManager) override;
 
+    std::string_view GetResourceTypeName() const override { return Shader::TYPE_NAME; }
     bool CanLoad(const std::string_view extension) const override {
         return extension == ".vert" || extension == ".frag";
     }
 private:
-    std::string ReadFile(const std::filesystem::path& path);
+    // Reads through the resource manager, so sources can come from a pack archive
+    static bool ReadFile(ResourceManager* resourceManager, const std::string& path, std::string& source);
 };
 }  // namespace Cleave
\ No newline at end of file
@@ -9,7 +9,8 @@ public:
     Sound() : m_data(nullptr) {};
     ~Sound() = default;
 
-    std::string_view GetTypeName() const override { return "cleave::Sound"; }
+    static constexpr std::string_view TYPE_NAME = "cleave::Sound";
+    std::string_view GetTypeName() const override { return TYPE_NAME; }
 
     void* GetData() const;
     void SetData(void* data);
@@ -21,6 +22,7 @@ class SoundLoader : public ResourceLoader {
 public:
     std::shared_ptr<Resource> Load(const std::string& path, ResourceManager* resourceManager) override;
 
+    std::string_view GetResourceTypeName() const override { return Sound::TYPE_NAME; }
     bool CanLoad(const std::string_view extension) const override {
         return extension == ".wav" || extension == ".mp3" ||
                extension == ".ogg" || extension == ".flac";
@@ -0,0 +1,3 @@
+// The one stb_image implementation, shared by the runtime and the tools that link it
+#define STB_IMAGE_IMPLEMENTATION
+#include "thirdparty/stb_image.h"
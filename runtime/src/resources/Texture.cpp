@@ -5,9 +5,50 @@
 #include "thirdparty/stb_image.h"
 
 #include "services/ResourceManager.hpp"
+#include "resources/CookedTexture.hpp"
+#include "resources/TextureAtlas.hpp"
 #include "rendering/Renderer.hpp"
 
 namespace Cleave {
+namespace {
+std::shared_ptr<Resource> ApplyTextureInfo(std::shared_ptr<Texture> texture, const Renderer::TextureInfo& info) {
+    if (info.handle == 0) return nullptr;
+    texture->SetHandle(info.handle);
+    texture->SetWidth(info.width);
+    texture->SetHeight(info.height);
+    texture->SetFormat(info.format);
+    return texture;
+}
+
+// Levels are uploaded straight from the file's bytes, which the completion keeps alive
+ResourceLoader::Completion PrepareCooked(const std::string& path, ResourceManager* resourceManager,
+                                         std::shared_ptr<ResourceData> data, const CookedTexture& cooked) {
+    return [path, resourceManager, data, cooked]() -> std::shared_ptr<Resource> {
+        auto texture = std::make_shared<Texture>();
+        texture->SetPath(path);
+        texture->SetPremultiplied(cooked.IsPremultiplied());
+
+        // Atlas pages are RGBA without mipmaps, so only textures cooked that way can join one
+        TextureAtlas& atlas = resourceManager->GetTextureAtlas();
+        if (cooked.GetFormat() == TextureFormat::RGBA && cooked.GetLevelCount() == 1 &&
+            atlas.Accepts(cooked.GetWidth(), cooked.GetHeight())) {
+            texture->SetWidth(cooked.GetWidth());
+            texture->SetHeight(cooked.GetHeight());
+            texture->SetFormat(TextureFormat::RGBA);
+            atlas.Add(texture, cooked.GetLevel(0).data(), cooked.GetWidth(), cooked.GetHeight());
+            return texture;
+        }
+
+        std::vector<const uint8_t*> levels;
+        for (uint32_t i = 0; i < cooked.GetLevelCount(); i++) {
+            levels.push_back(cooked.GetLevel(i).data());
+        }
+        return ApplyTextureInfo(texture, resourceManager->GetRenderer()->CreateTexture(
+                                             levels, cooked.GetWidth(), cooked.GetHeight(), cooked.GetFormat(), true));
+    };
+}
+}  // namespace
+
 int Texture::GetWidth() const { return m_width; }
 void Texture::SetWidth(int width) { m_width = width; }
 
@@ -17,21 +58,65 @@ void Texture::SetHeight(int height) { m_height = height; }
 TextureFormat Texture::GetFormat() const { return m_format; }
 void Texture::SetFormat(TextureFormat format) { m_format = format; }
 
+Rect4f Texture::GetUVRect() const { return m_uvRect; }
+void Texture::SetUVRect(Rect4f rect) { m_uvRect = rect; }
+Vec2f Texture::MapUV(Vec2f uv) const {
+    return {m_uvRect.x + uv.x * m_uvRect.w, m_uvRect.y + uv.y * m_uvRect.h};
+}
+
+bool Texture::IsPremultiplied() const { return m_premultiplied; }
+void Texture::SetPremultiplied(bool premultiplied) { m_premultiplied = premultiplied; }
+
 TextureHandle Texture::GetHandle() const { return m_handle; }
 void Texture::SetHandle(TextureHandle handle) { m_handle = handle; }
 
 std::shared_ptr<Resource> TextureLoader::Load(const std::string& path, ResourceManager* resourceManager) {
-    auto texture = std::make_shared<Texture>();
-    texture->SetPath(path);
-    auto textureInfo = resourceManager->GetRenderer()->CreateTexture(path);
-    if (textureInfo.handle != 0) {
-        texture->SetHandle(textureInfo.handle);
-        texture->SetWidth(textureInfo.width);
-        texture->SetHeight(textureInfo.height);
-        texture->SetFormat(textureInfo.format);
-        return texture;
+    return Prepare(path, resourceManager)();
+}
+
+ResourceLoader::Completion TextureLoader::Prepare(const std::string& path, ResourceManager* resourceManager) {
+    // Cooked data is used whenever it's at least as new as the source image
+    const std::string cookedPath = path + CookedTexture::EXTENSION;
+    std::filesystem::file_time_type cookedTime, sourceTime;
+    if (resourceManager->GetModifiedTime(cookedPath, cookedTime) &&
+        (!resourceManager->GetModifiedTime(path, sourceTime) || cookedTime >= sourceTime)) {
+        auto data = std::make_shared<ResourceData>();
+        CookedTexture cooked;
+        if (resourceManager->ReadResource(cookedPath, *data) && cooked.Open(data->GetBytes())) {
+            return PrepareCooked(path, resourceManager, std::move(data), cooked);
+        }
+        LOG_WARN("Invalid cooked texture, decoding the source instead: " << cookedPath);
     }
 
-    return nullptr;
+    int width = 0, height = 0, channels = 0;
+    std::shared_ptr<unsigned char> pixels;
+    ResourceData data;
+    if (resourceManager->ReadResource(path, data)) {
+        pixels.reset(stbi_load_from_memory(data.GetBytes().data(), static_cast<int>(data.GetSize()), &width, &height, &channels, STBI_rgb_alpha),
+                     stbi_image_free);
+    }
+
+    return [path, resourceManager, pixels, width, height]() -> std::shared_ptr<Resource> {
+        auto texture = std::make_shared<Texture>();
+        texture->SetPath(path);
+
+        Renderer::TextureInfo info;
+        if (!pixels) {
+            LOG_ERROR("Failed to load texture from file: " << path);
+            info = resourceManager->GetRenderer()->CreateFallbackTexture();
+        } else {
+            // Small images found during a scan are uploaded later as part of an atlas page
+            TextureAtlas& atlas = resourceManager->GetTextureAtlas();
+            if (atlas.Accepts(width, height)) {
+                texture->SetWidth(width);
+                texture->SetHeight(height);
+                texture->SetFormat(TextureFormat::RGBA);
+                atlas.Add(texture, pixels.get(), width, height);
+                return texture;
+            }
+            info = resourceManager->GetRenderer()->CreateTexture(pixels.get(), width, height, TextureFormat::RGBA, true);
+        }
+        return ApplyTextureInfo(texture, info);
+    };
 }
 }  // namespace Cleave
\ No newline at end of file
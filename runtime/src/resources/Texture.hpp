@@ -2,6 +2,8 @@
 #include <string>
 
 #include "rendering/TextureFormat.hpp"
+#include "math/Rect4.hpp"
+#include "math/Vec2.hpp"
 #include "Resource.hpp"
 
 namespace Cleave {
@@ -11,7 +13,8 @@ public:
     Texture() : m_width(1), m_height(1), m_format(TextureFormat::RGB) {};
     ~Texture() override = default;
 
-    std::string_view GetTypeName() const override { return "cleave::Texture"; }
+    static constexpr std::string_view TYPE_NAME = "cleave::Texture";
+    std::string_view GetTypeName() const override { return TYPE_NAME; }
 
     TextureHandle GetHandle() const;
     void SetHandle(TextureHandle handle);
@@ -24,17 +27,35 @@ public:
 
     TextureFormat GetFormat() const;
     void SetFormat(TextureFormat format);
+
+    // Region of the GL texture this image occupies, the whole texture unless it was atlased
+    Rect4f GetUVRect() const;
+    void SetUVRect(Rect4f rect);
+    Vec2f MapUV(Vec2f uv) const;
+
+    // Cooked textures store color multiplied by alpha, and are drawn with a matching blend
+    bool IsPremultiplied() const;
+    void SetPremultiplied(bool premultiplied);
 private:
     TextureHandle m_handle = -1;
     int m_width, m_height;
     TextureFormat m_format;
+    Rect4f m_uvRect = {0.0f, 0.0f, 1.0f, 1.0f};
+    bool m_premultiplied = false;
 };
 
 class TextureLoader : public ResourceLoader {
 public:
     std::shared_ptr<Resource> Load(const std::string& path, ResourceManager* resourceManager) override;
+    // Reads the cooked .ctex next to the image when it's up to date and decodes the image
+    // otherwise; the completion uploads it or hands it to the texture atlas
+    Completion Prepare(const std::string& path, ResourceManager* resourceManager) override;
+
+    std::string_view GetResourceTypeName() const override { return Texture::TYPE_NAME; }
+    bool CanLoad(const std::string_view extension) const override { return IsImageExtension(extension); }
 
-    bool CanLoad(const std::string_view extension) const override {
+    // The formats stb_image decodes. Static so offline tools can filter files without a loader.
+    static bool IsImageExtension(const std::string_view extension) {
         return extension == ".png" || extension == ".jpg" ||
                extension == ".jpeg" || extension == ".bmp" ||
                extension == ".tga" || extension == ".gif" ||
@@ -0,0 +1,113 @@
+#include "resources/TextureAtlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Log.hpp"
+#include "resources/Texture.hpp"
+#include "rendering/Renderer.hpp"
+#include "rendering/ShelfPacker.hpp"
+
+namespace Cleave {
+// Each entry is surrounded by a copy of its edge pixels so filtering never reaches a neighbour
+constexpr int EXTRUDE = 1;
+
+void TextureAtlas::Begin() {
+    m_pending.clear();
+    m_collecting = true;
+}
+
+bool TextureAtlas::IsCollecting() const { return m_collecting; }
+
+bool TextureAtlas::Accepts(int width, int height) const {
+    return m_collecting && width > 0 && height > 0 && width <= MAX_ENTRY_SIZE && height <= MAX_ENTRY_SIZE;
+}
+
+void TextureAtlas::Add(std::shared_ptr<Texture> texture, const uint8_t* pixels, int width, int height) {
+    Entry entry;
+    entry.texture = std::move(texture);
+    entry.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    entry.width = width;
+    entry.height = height;
+    m_pending.push_back(std::move(entry));
+}
+
+void TextureAtlas::Build(Renderer* renderer) {
+    m_collecting = false;
+    if (m_pending.empty()) return;
+
+    // Tallest first keeps shelves evenly filled. Entries arrive in whatever order the scan
+    // finished decoding them, so ties are broken by path to keep the layout stable.
+    std::sort(m_pending.begin(), m_pending.end(), [](const Entry& a, const Entry& b) {
+        if (a.height != b.height) return a.height > b.height;
+        return a.texture->GetPath() < b.texture->GetPath();
+    });
+
+    struct Placement {
+        size_t entry;
+        Vec2i position;
+    };
+
+    struct Page {
+        ShelfPacker packer{PAGE_SIZE, PAGE_SIZE, 0};
+        std::vector<Placement> placements;
+    };
+
+    std::vector<Page> pages;
+    for (size_t i = 0; i < m_pending.size(); i++) {
+        const Entry& entry = m_pending[i];
+        const int width = entry.width + EXTRUDE * 2;
+        const int height = entry.height + EXTRUDE * 2;
+
+        Vec2i position;
+        Page* target = nullptr;
+        for (Page& page : pages) {
+            if (page.packer.Pack(width, height, position) != -1) {
+                target = &page;
+                break;
+            }
+        }
+        if (!target) {
+            target = &pages.emplace_back();
+            target->packer.Pack(width, height, position);
+        }
+        target->placements.push_back({i, position});
+    }
+
+    for (Page& page : pages) {
+        // Pages are cut down to the shelves actually used
+        const int pageHeight = page.packer.GetUsedHeight();
+        std::vector<uint8_t> pixels(static_cast<size_t>(PAGE_SIZE) * pageHeight * 4, 0);
+
+        for (const Placement& placement : page.placements) {
+            const Entry& entry = m_pending[placement.entry];
+            const int originX = placement.position.x + EXTRUDE;
+            const int originY = placement.position.y + EXTRUDE;
+
+            for (int y = -EXTRUDE; y < entry.height + EXTRUDE; y++) {
+                const int sourceY = std::clamp(y, 0, entry.height - 1);
+                for (int x = -EXTRUDE; x < entry.width + EXTRUDE; x++) {
+                    const int sourceX = std::clamp(x, 0, entry.width - 1);
+                    std::memcpy(&pixels[((originY + y) * PAGE_SIZE + originX + x) * 4],
+                                &entry.pixels[(sourceY * entry.width + sourceX) * 4], 4);
+                }
+            }
+        }
+
+        Renderer::TextureInfo info = renderer->CreateTexture(pixels.data(), PAGE_SIZE, pageHeight, TextureFormat::RGBA);
+        for (const Placement& placement : page.placements) {
+            const Entry& entry = m_pending[placement.entry];
+            entry.texture->SetHandle(info.handle);
+            entry.texture->SetUVRect({
+                static_cast<float>(placement.position.x + EXTRUDE) / PAGE_SIZE,
+                static_cast<float>(placement.position.y + EXTRUDE) / pageHeight,
+                static_cast<float>(entry.width) / PAGE_SIZE,
+                static_cast<float>(entry.height) / pageHeight
+            });
+        }
+    }
+
+    LOG_INFO("Packed " << m_pending.size() << " textures into " << pages.size() << " atlas pages");
+    m_pending.clear();
+}
+}  // namespace Cleave
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Cleave {
+class Renderer;
+class Texture;
+
+// Collects small textures while resources are scanned and packs them into shared pages,
+// so sprites drawn from different images can still land in the same batch. Atlased textures
+// clamp at their edges: UVs outside 0-1 don't tile, so images meant to repeat have to be
+// larger than MAX_ENTRY_SIZE or cooked with mipmaps to keep their own GL texture.
+class TextureAtlas {
+public:
+    static constexpr int PAGE_SIZE = 2048;
+    static constexpr int MAX_ENTRY_SIZE = 256;
+
+    void Begin();
+    bool IsCollecting() const;
+    bool Accepts(int width, int height) const;
+
+    // Copies width x height RGBA8 pixels; the texture gets its page handle and UV rect in Build()
+    void Add(std::shared_ptr<Texture> texture, const uint8_t* pixels, int width, int height);
+    void Build(Renderer* renderer);
+
+private:
+    struct Entry {
+        std::shared_ptr<Texture> texture;
+        std::vector<uint8_t> pixels;
+        int width = 0;
+        int height = 0;
+    };
+
+    std::vector<Entry> m_pending;
+    bool m_collecting = false;
+};
+}  // namespace Cleave
@@ -0,0 +1,573 @@
+#include "scene/BinarySceneSerializer.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "EntityRegistry.hpp"
+#include "entities/Entity.hpp"
+#include "platform/MappedFile.hpp"
+#include "profiling/Profiler.hpp"
+#include "scene/Scene.hpp"
+#include "scene/SceneLoad.hpp"
+#include "Log.hpp"
+
+namespace Cleave {
+namespace {
+constexpr char MAGIC[4] = {'B', 'S', 'C', 'N'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t FLAG_DENSE_STORAGE = 1 << 0;
+constexpr uint32_t NO_PARENT = UINT32_MAX;  // The entity is a child of the scene root
+
+// Sections start on 8 byte boundaries, so the tables are read in place from the mapping.
+// Everything is stored in the machine's native (little endian) byte order.
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t stringCount;
+    uint32_t typeCount;
+    uint32_t columnCount;
+    uint32_t entityCount;
+    uint32_t reserved;
+    uint64_t stringsOffset;
+    uint64_t stringDataOffset;
+    uint64_t stringDataSize;
+    uint64_t typesOffset;
+    uint64_t columnsOffset;
+    uint64_t entitiesOffset;
+    uint64_t valuesOffset;
+    uint64_t valuesSize;
+};
+
+struct StringEntry {
+    uint32_t offset;  // Into the string data
+    uint32_t length;
+};
+
+// An entity type and the block holding the records of all its entities
+struct TypeEntry {
+    uint32_t name;
+    uint32_t firstColumn;
+    uint32_t columnCount;
+    uint32_t recordSize;
+    uint32_t recordCount;
+    uint32_t reserved;
+    uint64_t blockOffset;  // Into the values section
+};
+
+// Where one property sits in its type's records
+struct ColumnEntry {
+    uint32_t name;
+    uint32_t type;  // PropertyType
+    uint32_t offset;
+};
+
+// Entities are stored in pre-order, so parents always come first
+struct EntityEntry {
+    uint32_t type;
+    uint32_t parent;  // Index of an earlier entity, or NO_PARENT
+    uint32_t record;  // Within the type's block
+};
+
+uint64_t Align8(uint64_t offset) { return (offset + 7) & ~uint64_t(7); }
+
+uint32_t GetValueSize(PropertyType type) {
+    switch (type) {
+        case PropertyType::Double:
+        case PropertyType::Vec2f:
+        case PropertyType::EntityId:
+            return 8;
+        default:
+            return 4;  // 32-bit numbers and bools, or an index into the string table
+    }
+}
+
+template <typename T>
+T ReadRaw(const uint8_t* source) {
+    T value;
+    std::memcpy(&value, source, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void WriteRaw(uint8_t* dest, const T& value) {
+    std::memcpy(dest, &value, sizeof(T));
+}
+
+// Validated view over a mapped .bscn file
+class SceneFileView {
+public:
+    bool Open(const uint8_t* data, size_t size) {
+        if (size < sizeof(FileHeader)) return false;
+        m_data = data;
+        m_header = reinterpret_cast<const FileHeader*>(data);
+        if (std::memcmp(m_header->magic, MAGIC, sizeof(MAGIC)) != 0 || m_header->version != VERSION) return false;
+
+        auto inFile = [size](uint64_t offset, uint64_t bytes) {
+            return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+        };
+        const FileHeader& header = *m_header;
+        if (!inFile(header.stringsOffset, uint64_t(header.stringCount) * sizeof(StringEntry)) ||
+            !inFile(header.stringDataOffset, header.stringDataSize) ||
+            !inFile(header.typesOffset, uint64_t(header.typeCount) * sizeof(TypeEntry)) ||
+            !inFile(header.columnsOffset, uint64_t(header.columnCount) * sizeof(ColumnEntry)) ||
+            !inFile(header.entitiesOffset, uint64_t(header.entityCount) * sizeof(EntityEntry)) ||
+            !inFile(header.valuesOffset, header.valuesSize)) {
+            return false;
+        }
+
+        m_strings = {reinterpret_cast<const StringEntry*>(data + header.stringsOffset), header.stringCount};
+        m_types = {reinterpret_cast<const TypeEntry*>(data + header.typesOffset), header.typeCount};
+        m_columns = {reinterpret_cast<const ColumnEntry*>(data + header.columnsOffset), header.columnCount};
+        m_entities = {reinterpret_cast<const EntityEntry*>(data + header.entitiesOffset), header.entityCount};
+
+        for (const TypeEntry& type : m_types) {
+            if (uint64_t(type.firstColumn) + type.columnCount > m_columns.size() ||
+                type.blockOffset > header.valuesSize ||
+                uint64_t(type.recordSize) * type.recordCount > header.valuesSize - type.blockOffset) {
+                return false;
+            }
+            for (const ColumnEntry& column : GetColumns(type)) {
+                if (column.type > static_cast<uint32_t>(PropertyType::EntityId) ||
+                    uint64_t(column.offset) + GetValueSize(static_cast<PropertyType>(column.type)) > type.recordSize) {
+                    return false;
+                }
+            }
+        }
+        for (size_t i = 0; i < m_entities.size(); i++) {
+            const EntityEntry& entity = m_entities[i];
+            if (entity.type >= m_types.size() || entity.record >= m_types[entity.type].recordCount ||
+                (entity.parent != NO_PARENT && entity.parent >= i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const FileHeader& GetHeader() const { return *m_header; }
+    std::span<const TypeEntry> GetTypes() const { return m_types; }
+    std::span<const EntityEntry> GetEntities() const { return m_entities; }
+    std::span<const ColumnEntry> GetColumns(const TypeEntry& type) const {
+        return m_columns.subspan(type.firstColumn, type.columnCount);
+    }
+
+    bool GetString(uint32_t index, std::string_view& value) const {
+        if (index >= m_strings.size()) return false;
+        const StringEntry& entry = m_strings[index];
+        if (uint64_t(entry.offset) + entry.length > m_header->stringDataSize) return false;
+        value = {reinterpret_cast<const char*>(m_data + m_header->stringDataOffset + entry.offset), entry.length};
+        return true;
+    }
+
+    const uint8_t* GetRecord(const TypeEntry& type, uint32_t record) const {
+        return m_data + m_header->valuesOffset + type.blockOffset + uint64_t(type.recordSize) * record;
+    }
+
+    bool ReadValue(const ColumnEntry& column, const uint8_t* record, PropertyValue& value) const {
+        const uint8_t* source = record + column.offset;
+        switch (static_cast<PropertyType>(column.type)) {
+            case PropertyType::Int:
+                value = static_cast<int>(ReadRaw<int32_t>(source));
+                return true;
+            case PropertyType::Float:
+                value = ReadRaw<float>(source);
+                return true;
+            case PropertyType::Double:
+                value = ReadRaw<double>(source);
+                return true;
+            case PropertyType::Bool:
+                value = ReadRaw<uint32_t>(source) != 0;
+                return true;
+            case PropertyType::Vec2f:
+                value = Vec2f(ReadRaw<float>(source), ReadRaw<float>(source + 4));
+                return true;
+            case PropertyType::EntityId:
+                value = ReadRaw<EntityId>(source);
+                return true;
+            case PropertyType::String:
+            case PropertyType::FilePath:
+            case PropertyType::Hidden: {
+                std::string_view text;
+                if (!GetString(ReadRaw<uint32_t>(source), text)) return false;
+                value = std::string(text);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const uint8_t* m_data = nullptr;
+    const FileHeader* m_header = nullptr;
+    std::span<const StringEntry> m_strings;
+    std::span<const TypeEntry> m_types;
+    std::span<const ColumnEntry> m_columns;
+    std::span<const EntityEntry> m_entities;
+};
+
+class SceneFileWriter {
+public:
+    // `values` are in the order PropertyList::ForEach visits `properties`
+    uint32_t AddEntity(const PropertyList& properties, uint32_t parent, const std::vector<PropertyValue>& values) {
+        auto [it, inserted] = m_typeIndices.try_emplace(properties.typeName, static_cast<uint32_t>(m_types.size()));
+        if (inserted) {
+            Type type;
+            type.entry.name = AddString(properties.typeName);
+            type.entry.firstColumn = static_cast<uint32_t>(m_columns.size());
+            properties.ForEach([&](const PropertyDescriptor& property) {
+                m_columns.push_back({AddString(property.name), static_cast<uint32_t>(property.type), type.entry.recordSize});
+                type.entry.recordSize += GetValueSize(property.type);
+            });
+            type.entry.columnCount = static_cast<uint32_t>(m_columns.size()) - type.entry.firstColumn;
+            m_types.push_back(std::move(type));
+        }
+
+        Type& type = m_types[it->second];
+        const uint32_t record = type.entry.recordCount++;
+        type.block.resize(type.block.size() + type.entry.recordSize);
+        uint8_t* dest = type.block.data() + size_t(record) * type.entry.recordSize;
+        for (uint32_t i = 0; i < type.entry.columnCount && i < values.size(); i++) {
+            const ColumnEntry& column = m_columns[type.entry.firstColumn + i];
+            WriteValue(static_cast<PropertyType>(column.type), values[i], dest + column.offset);
+        }
+
+        m_entities.push_back({it->second, parent, record});
+        return static_cast<uint32_t>(m_entities.size() - 1);
+    }
+
+    bool Write(const std::string_view path, uint32_t flags) {
+        FileHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.flags = flags;
+        header.stringCount = static_cast<uint32_t>(m_strings.size());
+        header.typeCount = static_cast<uint32_t>(m_types.size());
+        header.columnCount = static_cast<uint32_t>(m_columns.size());
+        header.entityCount = static_cast<uint32_t>(m_entities.size());
+
+        for (Type& type : m_types) {
+            type.entry.blockOffset = header.valuesSize;
+            header.valuesSize = Align8(header.valuesSize + type.block.size());
+        }
+        header.stringsOffset = Align8(sizeof(FileHeader));
+        header.stringDataOffset = Align8(header.stringsOffset + m_strings.size() * sizeof(StringEntry));
+        header.stringDataSize = m_stringData.size();
+        header.typesOffset = Align8(header.stringDataOffset + header.stringDataSize);
+        header.columnsOffset = Align8(header.typesOffset + m_types.size() * sizeof(TypeEntry));
+        header.entitiesOffset = Align8(header.columnsOffset + m_columns.size() * sizeof(ColumnEntry));
+        header.valuesOffset = Align8(header.entitiesOffset + m_entities.size() * sizeof(EntityEntry));
+
+        std::vector<uint8_t> buffer(header.valuesOffset + header.valuesSize);
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        std::memcpy(buffer.data() + header.stringsOffset, m_strings.data(), m_strings.size() * sizeof(StringEntry));
+        std::memcpy(buffer.data() + header.stringDataOffset, m_stringData.data(), m_stringData.size());
+        std::memcpy(buffer.data() + header.columnsOffset, m_columns.data(), m_columns.size() * sizeof(ColumnEntry));
+        std::memcpy(buffer.data() + header.entitiesOffset, m_entities.data(), m_entities.size() * sizeof(EntityEntry));
+        for (size_t i = 0; i < m_types.size(); i++) {
+            std::memcpy(buffer.data() + header.typesOffset + i * sizeof(TypeEntry), &m_types[i].entry, sizeof(TypeEntry));
+            std::memcpy(buffer.data() + header.valuesOffset + m_types[i].entry.blockOffset, m_types[i].block.data(), m_types[i].block.size());
+        }
+
+        std::ofstream file(std::string(path), std::ios::binary);
+        if (!file.is_open()) {
+            LOG_ERROR("Failed to open file for writing: " << path);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        return file.good();
+    }
+
+private:
+    struct Type {
+        TypeEntry entry = {};
+        std::vector<uint8_t> block;
+    };
+
+    uint32_t AddString(const std::string_view value) {
+        auto [it, inserted] = m_stringIndices.try_emplace(std::string(value), static_cast<uint32_t>(m_strings.size()));
+        if (inserted) {
+            m_strings.push_back({static_cast<uint32_t>(m_stringData.size()), static_cast<uint32_t>(value.size())});
+            m_stringData.append(value);
+        }
+        return it->second;
+    }
+
+    // Values that don't hold the column's type are left zeroed
+    void WriteValue(PropertyType type, const PropertyValue& value, uint8_t* dest) {
+        switch (type) {
+            case PropertyType::Int:
+                if (const int* typed = std::get_if<int>(&value)) WriteRaw(dest, static_cast<int32_t>(*typed));
+                break;
+            case PropertyType::Float:
+                if (const float* typed = std::get_if<float>(&value)) WriteRaw(dest, *typed);
+                break;
+            case PropertyType::Double:
+                if (const double* typed = std::get_if<double>(&value)) WriteRaw(dest, *typed);
+                break;
+            case PropertyType::Bool:
+                if (const bool* typed = std::get_if<bool>(&value)) WriteRaw(dest, static_cast<uint32_t>(*typed));
+                break;
+            case PropertyType::Vec2f:
+                if (const Vec2f* typed = std::get_if<Vec2f>(&value)) {
+                    WriteRaw(dest, typed->x);
+                    WriteRaw(dest + 4, typed->y);
+                }
+                break;
+            case PropertyType::EntityId:
+                if (const EntityId* typed = std::get_if<EntityId>(&value)) WriteRaw(dest, *typed);
+                break;
+            case PropertyType::String:
+            case PropertyType::FilePath:
+            case PropertyType::Hidden:
+                if (const std::string* typed = std::get_if<std::string>(&value)) WriteRaw(dest, AddString(*typed));
+                break;
+        }
+    }
+
+    std::vector<StringEntry> m_strings;
+    std::string m_stringData;
+    std::unordered_map<std::string, uint32_t> m_stringIndices;
+    std::vector<Type> m_types;
+    std::unordered_map<std::string_view, uint32_t> m_typeIndices;  // Type names are static strings
+    std::vector<ColumnEntry> m_columns;
+    std::vector<EntityEntry> m_entities;
+};
+}  // namespace
+
+std::shared_ptr<Scene> BinarySceneSerializer::Load(const std::string_view path) {
+    MappedFile file;
+    if (!file.Open(path)) {
+        LOG_ERROR("Failed to open: " << path);
+        return nullptr;
+    }
+    return LoadFromMemory({file.GetData(), file.GetSize()}, path);
+}
+
+std::shared_ptr<Scene> BinarySceneSerializer::LoadFromMemory(std::span<const uint8_t> data, const std::string_view path) {
+    CLEAVE_PROFILE_SCOPE("BinarySceneSerializer::Load");
+    SceneFileView view;
+    if (!view.Open(data.data(), data.size())) {
+        LOG_ERROR("Invalid binary scene: " << path);
+        return nullptr;
+    }
+
+    auto scene = std::make_shared<Scene>(std::make_unique<Entity>(Transform()));
+    // Attach before the tree is built so entities move into storage as they're added
+    if (view.GetHeader().flags & FLAG_DENSE_STORAGE) {
+        scene->SetDenseStorage(true);
+    }
+
+    // Per file type, the factory and, for each of the type's descriptors, the column
+    // holding its value or -1. Columns are matched up once the first instance exists.
+    struct ResolvedType {
+        const std::function<std::unique_ptr<Entity>()>* factory = nullptr;
+        bool resolved = false;
+        std::vector<int32_t> columns;
+    };
+    std::vector<ResolvedType> types(view.GetTypes().size());
+    for (size_t i = 0; i < types.size(); i++) {
+        std::string_view name;
+        view.GetString(view.GetTypes()[i].name, name);
+        auto it = Registry::GetAllTypes().find(std::string(name));
+        if (it != Registry::GetAllTypes().end()) {
+            types[i].factory = &it->second;
+        } else {
+            LOG_WARN("Unknown entity type '" << name << "' in " << path);
+        }
+    }
+
+    std::vector<Entity*> entities(view.GetEntities().size(), nullptr);
+    for (size_t i = 0; i < entities.size(); i++) {
+        SceneLoad::ReportProgress(static_cast<float>(i) / entities.size());
+        const EntityEntry& entry = view.GetEntities()[i];
+        Entity* parent = entry.parent == NO_PARENT ? scene->GetRoot() : entities[entry.parent];
+        ResolvedType& type = types[entry.type];
+        // Unknown types drop their whole subtree, as they do in JSON scenes
+        if (!parent || !type.factory) continue;
+
+        std::unique_ptr<Entity> entity = (*type.factory)();
+        const TypeEntry& typeEntry = view.GetTypes()[entry.type];
+        const std::span<const ColumnEntry> columns = view.GetColumns(typeEntry);
+        if (!type.resolved) {
+            entity->GetPropertyList().ForEach([&](const PropertyDescriptor& property) {
+                int32_t match = -1;
+                for (size_t column = 0; column < columns.size(); column++) {
+                    std::string_view name;
+                    if (view.GetString(columns[column].name, name) && name == property.name &&
+                        columns[column].type == static_cast<uint32_t>(property.type)) {
+                        match = static_cast<int32_t>(column);
+                        break;
+                    }
+                }
+                type.columns.push_back(match);
+            });
+            type.resolved = true;
+        }
+
+        const uint8_t* record = view.GetRecord(typeEntry, entry.record);
+        size_t next = 0;
+        entity->Init([&](const PropertyDescriptor&, PropertyValue& value) {
+            const int32_t column = type.columns[next++];
+            return column >= 0 && view.ReadValue(columns[column], record, value);
+        });
+
+        entities[i] = entity.get();
+        parent->AddChild(std::move(entity));
+    }
+
+    return scene;
+}
+
+bool BinarySceneSerializer::Save(const std::string_view path, Scene* scene) {
+    SceneFileWriter writer;
+    std::vector<PropertyValue> values;
+    std::function<void(Entity*, uint32_t)> serialize = [&](Entity* entity, uint32_t parent) {
+        const PropertyList& properties = entity->GetPropertyList();
+        values.clear();
+        properties.ForEach([&](const PropertyDescriptor& property) { values.push_back(property.get(*entity)); });
+        const uint32_t index = writer.AddEntity(properties, parent, values);
+        for (const auto& child : entity->GetChildren()) {
+            serialize(child.get(), index);
+        }
+    };
+
+    if (scene->GetRoot()) {
+        for (const auto& child : scene->GetRoot()->GetChildren()) {
+            serialize(child.get(), NO_PARENT);
+        }
+    }
+    return writer.Write(path, scene->IsDenseStorage() ? FLAG_DENSE_STORAGE : 0);
+}
+
+bool BinarySceneSerializer::FromJson(const std::string_view jsonPath, const std::string_view binaryPath) {
+    std::ifstream file{std::string(jsonPath)};
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open: " << jsonPath);
+        return false;
+    }
+
+    nlohmann::json json;
+    try {
+        file >> json;
+    } catch (const std::exception& e) {
+        LOG_ERROR("JSON parse error: " << e.what());
+        return false;
+    }
+
+    SceneFileWriter writer;
+    std::vector<PropertyValue> values;
+    std::function<void(const nlohmann::json&, uint32_t)> convert = [&](const nlohmann::json& jsonData, uint32_t parent) {
+        // A throwaway instance provides the property list, and the defaults for missing values
+        std::unique_ptr<Entity> entity = Registry::CreateEntity(jsonData.value("type", ""));
+        if (!entity) {
+            LOG_WARN("Skipping entity of unknown type '" << jsonData.value("type", "") << "'");
+            return;
+        }
+
+        const PropertyList& properties = entity->GetPropertyList();
+        values.clear();
+        properties.ForEach([&](const PropertyDescriptor& property) {
+            PropertyValue value;
+            auto it = jsonData.find(property.name);
+            if (it == jsonData.end() || !it->is_string()) {
+                value = property.get(*entity);
+            } else if (!ParsePropertyValue(property.type, it->get_ref<const std::string&>(), value)) {
+                LOG_ERROR("Invalid value '" << it->get_ref<const std::string&>() << "' for property " << property.name);
+                value = property.get(*entity);
+            }
+            values.push_back(std::move(value));
+        });
+        const uint32_t index = writer.AddEntity(properties, parent, values);
+
+        if (jsonData.contains("children")) {
+            for (const auto& childJson : jsonData["children"]) {
+                convert(childJson, index);
+            }
+        }
+    };
+
+    try {
+        if (json.contains("children")) {
+            for (const auto& child : json["children"]) {
+                convert(child, NO_PARENT);
+            }
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("Scene conversion failed: " << e.what());
+        return false;
+    }
+    return writer.Write(binaryPath, json.value("storage", "") == "dense" ? FLAG_DENSE_STORAGE : 0);
+}
+
+bool BinarySceneSerializer::ToJson(const std::string_view binaryPath, const std::string_view jsonPath) {
+    MappedFile file;
+    if (!file.Open(binaryPath)) {
+        LOG_ERROR("Failed to open: " << binaryPath);
+        return false;
+    }
+    SceneFileView view;
+    if (!view.Open(file.GetData(), file.GetSize())) {
+        LOG_ERROR("Invalid binary scene: " << binaryPath);
+        return false;
+    }
+
+    // Child lists by entity, with the scene root last
+    const std::span<const EntityEntry> entities = view.GetEntities();
+    std::vector<std::vector<uint32_t>> children(entities.size() + 1);
+    for (uint32_t i = 0; i < entities.size(); i++) {
+        const uint32_t parent = entities[i].parent == NO_PARENT ? static_cast<uint32_t>(entities.size()) : entities[i].parent;
+        children[parent].push_back(i);
+    }
+
+    std::function<void(uint32_t, nlohmann::json&)> convert = [&](uint32_t index, nlohmann::json& jsonOut) {
+        const EntityEntry& entry = entities[index];
+        const TypeEntry& type = view.GetTypes()[entry.type];
+        const uint8_t* record = view.GetRecord(type, entry.record);
+
+        std::string_view name;
+        view.GetString(type.name, name);
+        jsonOut["type"] = name;
+        for (const ColumnEntry& column : view.GetColumns(type)) {
+            PropertyValue value;
+            if (view.GetString(column.name, name) && view.ReadValue(column, record, value)) {
+                jsonOut[name] = FormatPropertyValue(value);
+            }
+        }
+
+        if (!children[index].empty()) {
+            nlohmann::json childrenArray = nlohmann::json::array();
+            for (uint32_t child : children[index]) {
+                nlohmann::json childJson;
+                convert(child, childJson);
+                childrenArray.push_back(std::move(childJson));
+            }
+            jsonOut["children"] = std::move(childrenArray);
+        }
+    };
+
+    nlohmann::json json;
+    nlohmann::json childrenArray = nlohmann::json::array();
+    for (uint32_t child : children.back()) {
+        nlohmann::json childJson;
+        convert(child, childJson);
+        childrenArray.push_back(std::move(childJson));
+    }
+    json["children"] = std::move(childrenArray);
+    if (view.GetHeader().flags & FLAG_DENSE_STORAGE) {
+        json["storage"] = "dense";
+    }
+
+    std::ofstream out{std::string(jsonPath)};
+    if (!out.is_open()) {
+        LOG_ERROR("Failed to open file for writing: " << jsonPath);
+        return false;
+    }
+    out << json.dump(4);
+    return true;
+}
+}  // namespace Cleave
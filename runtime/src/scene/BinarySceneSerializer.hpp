@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace Cleave {
+class Scene;
+
+// .bscn scenes: a string table, one block of fixed-size typed records per entity type and
+// the hierarchy flattened in pre-order. Loading maps the file and copies values straight
+// into the entities' typed properties, so nothing is parsed.
+class BinarySceneSerializer {
+public:
+    static std::shared_ptr<Scene> Load(const std::string_view path);
+    // `data` must be 8 byte aligned; `path` is only used in log messages
+    static std::shared_ptr<Scene> LoadFromMemory(std::span<const uint8_t> data, const std::string_view path);
+    static bool Save(const std::string_view path, Scene* scene);
+
+    // Conversions between .jscn and .bscn files. Neither instantiates the scene, so resources
+    // the scene refers to don't have to be loaded.
+    static bool FromJson(const std::string_view jsonPath, const std::string_view binaryPath);
+    static bool ToJson(const std::string_view binaryPath, const std::string_view jsonPath);
+};
+}  // namespace Cleave
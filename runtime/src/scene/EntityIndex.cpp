@@ -0,0 +1,21 @@
+#include "scene/EntityIndex.hpp"
+
+namespace Cleave {
+bool EntityIndex::Add(Entity* entity) {
+    return m_entities.try_emplace(entity->GetId(), entity).second;
+}
+
+void EntityIndex::Remove(Entity* entity) {
+    auto it = m_entities.find(entity->GetId());
+    if (it != m_entities.end() && it->second == entity) {
+        m_entities.erase(it);
+    }
+}
+
+Entity* EntityIndex::Find(EntityId id) const {
+    auto it = m_entities.find(id);
+    return it != m_entities.end() ? it->second : nullptr;
+}
+
+size_t EntityIndex::GetCount() const { return m_entities.size(); }
+}  // namespace Cleave
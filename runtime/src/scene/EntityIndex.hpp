@@ -0,0 +1,20 @@
+#pragma once
+#include <unordered_map>
+
+#include "entities/Entity.hpp"
+
+namespace Cleave {
+// Id -> entity lookup for one scene. Entities register themselves as they join the scene's
+// tree and drop out when removed or destroyed, so lookups never walk the hierarchy.
+class EntityIndex {
+public:
+    // Returns false if another entity already holds the id
+    bool Add(Entity* entity);
+    void Remove(Entity* entity);
+    Entity* Find(EntityId id) const;
+    size_t GetCount() const;
+
+private:
+    std::unordered_map<EntityId, Entity*> m_entities;
+};
+}  // namespace Cleave
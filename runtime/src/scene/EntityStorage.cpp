@@ -0,0 +1,126 @@
+#include "scene/EntityStorage.hpp"
+
+#include "rendering/Material.hpp"
+
+namespace Cleave {
+uint32_t EntityStorage::Allocate(Entity* entity) {
+    uint32_t slot = m_transforms.Allocate({0.0f, 0.0f}, {1.0f, 1.0f}, 0.0f);
+    if (slot >= m_entities.size()) {
+        const size_t size = slot + 1;
+        m_depth.resize(size);
+        m_visible.resize(size);
+        m_entities.resize(size);
+        m_spriteIndex.resize(size, NONE);
+        m_animationIndex.resize(size, NONE);
+    }
+    m_depth[slot] = 0;
+    m_visible[slot] = 1;
+    m_entities[slot] = entity;
+    m_count++;
+    return slot;
+}
+
+void EntityStorage::Release(uint32_t slot) {
+    if (!m_transforms.IsAlive(slot)) return;
+    RemoveSprite(slot);
+    RemoveAnimation(slot);
+    m_entities[slot] = nullptr;
+    m_transforms.Release(slot);
+    m_count--;
+}
+
+uint32_t EntityStorage::GetCount() const { return m_count; }
+
+TransformStorage& EntityStorage::GetTransforms() { return m_transforms; }
+
+int EntityStorage::GetDepth(uint32_t slot) const { return m_depth[slot]; }
+void EntityStorage::SetDepth(uint32_t slot, int depth) { m_depth[slot] = depth; }
+
+bool EntityStorage::IsVisible(uint32_t slot) const { return m_visible[slot]; }
+void EntityStorage::SetVisible(uint32_t slot, bool visible) { m_visible[slot] = visible; }
+
+Entity* EntityStorage::GetEntity(uint32_t slot) const { return m_entities[slot]; }
+
+void EntityStorage::AddSprite(uint32_t slot, const Material* material) {
+    if (m_spriteIndex[slot] != NONE) {
+        m_sprites[m_spriteIndex[slot]].material = material;
+        return;
+    }
+    m_spriteIndex[slot] = static_cast<uint32_t>(m_sprites.size());
+    m_sprites.push_back({slot, material});
+}
+
+void EntityStorage::RemoveSprite(uint32_t slot) {
+    uint32_t index = m_spriteIndex[slot];
+    if (index == NONE) return;
+
+    // Swap-remove keeps the records packed
+    m_sprites[index] = m_sprites.back();
+    m_spriteIndex[m_sprites[index].slot] = index;
+    m_sprites.pop_back();
+    m_spriteIndex[slot] = NONE;
+}
+
+const Material* EntityStorage::GetSpriteMaterial(uint32_t slot) const {
+    uint32_t index = m_spriteIndex[slot];
+    return index == NONE ? nullptr : m_sprites[index].material;
+}
+
+EntityStorage::AnimationState& EntityStorage::AddAnimation(uint32_t slot, const AnimationState& state) {
+    uint32_t index = m_animationIndex[slot];
+    if (index == NONE) {
+        index = static_cast<uint32_t>(m_animations.size());
+        m_animationIndex[slot] = index;
+        m_animations.push_back(state);
+    } else {
+        m_animations[index] = state;
+    }
+    m_animations[index].slot = slot;
+    return m_animations[index];
+}
+
+void EntityStorage::RemoveAnimation(uint32_t slot) {
+    uint32_t index = m_animationIndex[slot];
+    if (index == NONE) return;
+
+    m_animations[index] = m_animations.back();
+    m_animationIndex[m_animations[index].slot] = index;
+    m_animations.pop_back();
+    m_animationIndex[slot] = NONE;
+}
+
+EntityStorage::AnimationState* EntityStorage::GetAnimation(uint32_t slot) {
+    uint32_t index = m_animationIndex[slot];
+    return index == NONE ? nullptr : &m_animations[index];
+}
+
+const EntityStorage::AnimationState* EntityStorage::GetAnimation(uint32_t slot) const {
+    uint32_t index = m_animationIndex[slot];
+    return index == NONE ? nullptr : &m_animations[index];
+}
+
+void EntityStorage::TickAnimations(float deltaTime) {
+    for (AnimationState& state : m_animations) {
+        if (!state.playing || state.frameDuration <= 0) continue;
+        const Material* material = GetSpriteMaterial(state.slot);
+        if (!material || !material->texture) continue;
+
+        state.time += deltaTime;
+        while (state.time >= state.frameDuration) {
+            state.time -= state.frameDuration;
+            state.frame++;
+
+            if (state.frame >= state.frameCount) {
+                if (state.loop) {
+                    state.frame = 0;
+                } else {
+                    state.frame = state.frameCount - 1;
+                    state.playing = false;
+                }
+            }
+        }
+    }
+}
+
+void EntityStorage::UpdateWorld() { m_transforms.UpdateWorld(); }
+}  // namespace Cleave
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "math/TransformStorage.hpp"
+#include "math/Vec2.hpp"
+
+namespace Cleave {
+class Entity;
+struct Material;
+
+// Dense per-type arrays backing the entities of a scene in dense storage mode. Entities keep
+// their ids, names and children; their transforms, depth, visibility, sprite materials and
+// animation state live here and are indexed by the entity's slot.
+class EntityStorage {
+public:
+    static constexpr uint32_t NONE = TransformStorage::NONE;
+
+    struct SpriteRecord {
+        uint32_t slot = NONE;
+        const Material* material = nullptr;
+    };
+
+    struct AnimationState {
+        uint32_t slot = NONE;
+        Vec2i frameSize = {32, 32};
+        int frameCount = 1;
+        int frame = 0;
+        float time = 0.0f;
+        float frameDuration = 0.1f;
+        bool playing = false;
+        bool loop = true;
+    };
+
+    uint32_t Allocate(Entity* entity);
+    // Drops the slot and every record attached to it
+    void Release(uint32_t slot);
+    uint32_t GetCount() const;
+
+    TransformStorage& GetTransforms();
+
+    int GetDepth(uint32_t slot) const;
+    void SetDepth(uint32_t slot, int depth);
+
+    bool IsVisible(uint32_t slot) const;
+    void SetVisible(uint32_t slot, bool visible);
+
+    Entity* GetEntity(uint32_t slot) const;
+
+    void AddSprite(uint32_t slot, const Material* material);
+    void RemoveSprite(uint32_t slot);
+    const Material* GetSpriteMaterial(uint32_t slot) const;
+
+    AnimationState& AddAnimation(uint32_t slot, const AnimationState& state);
+    void RemoveAnimation(uint32_t slot);
+    AnimationState* GetAnimation(uint32_t slot);
+    const AnimationState* GetAnimation(uint32_t slot) const;
+
+    // Advances every playing animation in one pass over the packed states
+    void TickAnimations(float deltaTime);
+    void UpdateWorld();
+
+private:
+    TransformStorage m_transforms;
+    std::vector<int> m_depth;
+    std::vector<uint8_t> m_visible;
+    std::vector<Entity*> m_entities;
+    uint32_t m_count = 0;
+
+    // Packed records; m_spriteIndex/m_animationIndex map a slot to its record or NONE
+    std::vector<SpriteRecord> m_sprites;
+    std::vector<uint32_t> m_spriteIndex;
+    std::vector<AnimationState> m_animations;
+    std::vector<uint32_t> m_animationIndex;
+};
+}  // namespace Cleave
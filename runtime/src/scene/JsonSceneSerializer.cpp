@@ -1,12 +1,15 @@
 #include "scene/JsonSceneSerializer.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
+#include <iterator>
 #include <nlohmann/json.hpp>
 
 #include "EntityRegistry.hpp"
 #include "entities/Entity.hpp"
 #include "scene/Scene.hpp"
+#include "scene/SceneLoad.hpp"
 #include "Log.hpp"
 
 namespace Cleave {
@@ -16,18 +19,35 @@ std::shared_ptr<Scene> JsonSceneSerializer::Load(const std::string_view path) {
         LOG_ERROR("Failed to open: " << path);
         return nullptr;
     }
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return LoadFromMemory(text);
+}
 
+std::shared_ptr<Scene> JsonSceneSerializer::LoadFromMemory(const std::string_view text) {
     nlohmann::json json;
     try {
-        file >> json;
+        json = nlohmann::json::parse(text);
     } catch (const std::exception& e) {
         LOG_ERROR("JSON parse error: " << e.what());
         return nullptr;
     }
 
-    std::vector<
-        std::pair<Entity*, std::unordered_map<std::string, Entity::Property>>>
-        pendingInits;
+    // Parsing counts for the first part of the progress, building entities for the rest
+    constexpr float PARSE_PROGRESS = 0.4f;
+    SceneLoad::ReportProgress(PARSE_PROGRESS);
+
+    std::function<size_t(const nlohmann::json&)> countEntities = [&](const nlohmann::json& jsonData) {
+        size_t count = 0;
+        if (jsonData.contains("children")) {
+            for (const auto& child : jsonData["children"]) {
+                count += 1 + countEntities(child);
+            }
+        }
+        return count;
+    };
+    const size_t entityCount = std::max<size_t>(countEntities(json), 1);
+    size_t built = 0;
+
     auto scene = std::make_shared<Scene>(std::make_unique<Entity>(Transform()));
 
     std::function<void(const nlohmann::json&, Entity*)> deserialize;
@@ -36,14 +56,22 @@ std::shared_ptr<Scene> JsonSceneSerializer::Load(const std::string_view path) {
         if (typeIt != Registry::GetAllTypes().end()) {
             std::unique_ptr<Entity> entity = Registry::CreateEntity(typeIt->first);
 
-            std::unordered_map<std::string, Entity::Property> props;
-            for (auto& [key, val] : jsonData.items()) {
-                if (key != "children") props[key].value = val.get<std::string>();
-            }
-            entity->Init(props);
+            // Text only exists here; each value is parsed straight into its descriptor's type
+            entity->Init([&](const PropertyDescriptor& property, PropertyValue& value) {
+                auto it = jsonData.find(property.name);
+                if (it == jsonData.end() || !it->is_string()) return false;
+
+                const std::string& text = it->get_ref<const std::string&>();
+                if (!ParsePropertyValue(property.type, text, value)) {
+                    LOG_ERROR("Invalid value '" << text << "' for property " << property.name);
+                    return false;
+                }
+                return true;
+            });
 
             Entity* rawPtr = entity.get();
             parent->AddChild(std::move(entity));
+            SceneLoad::ReportProgress(PARSE_PROGRESS + (1.0f - PARSE_PROGRESS) * ++built / entityCount);
 
             if (jsonData.contains("children")) {
                 for (auto& childJson : jsonData["children"]) {
@@ -54,15 +82,16 @@ std::shared_ptr<Scene> JsonSceneSerializer::Load(const std::string_view path) {
     };
 
     try {
+        // Attach before the tree is built so entities move into storage as they're added
+        if (json.value("storage", "") == "dense") {
+            scene->SetDenseStorage(true);
+        }
+
         if (json.contains("children")) {
             for (const auto& child : json["children"]) {
                 deserialize(child, scene->GetRoot());
             }
         }
-
-        for (auto& [entity, properties] : pendingInits) {
-            entity->Init(properties);
-        }
     } catch (const std::exception& e) {
         LOG_ERROR("Scene loading failed: " << e.what());
         return nullptr;
@@ -82,10 +111,11 @@ bool JsonSceneSerializer::Save(const std::string_view path, Scene* scene) {
 
     std::function<void(Entity*, nlohmann::json&)> serialize =
         [&serialize](Entity* entity, nlohmann::json& jsonOut) {
-            const auto& properties = entity->GetProperties();
-            for (auto& [key, prop] : properties) {
-                jsonOut[key] = prop.value;
-            }
+            const PropertyList& properties = entity->GetPropertyList();
+            jsonOut["type"] = properties.typeName;
+            properties.ForEach([&](const PropertyDescriptor& property) {
+                jsonOut[property.name] = FormatPropertyValue(property.get(*entity));
+            });
 
             const auto& children = entity->GetChildren();
             if (!children.empty()) {
@@ -100,6 +130,9 @@ bool JsonSceneSerializer::Save(const std::string_view path, Scene* scene) {
         };
 
     serialize(scene->GetRoot(), json);
+    if (scene->IsDenseStorage()) {
+        json["storage"] = "dense";
+    }
 
     file << json.dump(4);
 
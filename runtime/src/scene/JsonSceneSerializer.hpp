@@ -9,6 +9,7 @@ class Properties;
 class JsonSceneSerializer {
 public:
     static std::shared_ptr<Scene> Load(const std::string_view path);
+    static std::shared_ptr<Scene> LoadFromMemory(const std::string_view text);
     static bool Save(const std::string_view path, Scene* scene);
 };
 }  // namespace Cleave
\ No newline at end of file
@@ -1,46 +1,425 @@
 #include "scene/Scene.hpp"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <filesystem>
+#include <iterator>
+
+#include "scene/BinarySceneSerializer.hpp"
 #include "scene/JsonSceneSerializer.hpp"
+#include "scene/SceneLoad.hpp"
 #include "Scene.hpp"
 #include "Log.hpp"
 #include "services/ResourceManager.hpp"
+#include "jobs/JobSystem.hpp"
+#include "rendering/Renderer.hpp"
+#include "profiling/Profiler.hpp"
 
 namespace Cleave {
+namespace {
+// World rect visible through a 2D projection, found by mapping the clip-space corners back
+bool GetViewRect(const Matrix4& projection, Rect4f& rect) {
+    const float a = projection.m[0][0], b = projection.m[1][0];
+    const float c = projection.m[0][1], d = projection.m[1][1];
+    const float det = a * d - b * c;
+    if (std::fabs(det) < 1e-12f) return false;
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (float nx : {-1.0f, 1.0f}) {
+        for (float ny : {-1.0f, 1.0f}) {
+            const float px = nx - projection.m[3][0];
+            const float py = ny - projection.m[3][1];
+            const float x = (d * px - b * py) / det;
+            const float y = (a * py - c * px) / det;
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+        }
+    }
+    rect = {minX, minY, maxX - minX, maxY - minY};
+    return true;
+}
+}  // namespace
+
+Scene::Scene(std::unique_ptr<Entity> root) { SetRoot(std::move(root)); }
+
 std::shared_ptr<Scene> Scene::Instantiate() const {
-    return std::dynamic_pointer_cast<Scene>(SceneLoader().Load(GetPath(), GET_RESMGR()));
+    std::unique_ptr<Entity> root = InstantiateRoot();
+    if (!root) return nullptr;
+
+    auto scene = std::make_shared<Scene>();
+    // Storage first, so the copied entities move into it as the root is set
+    scene->SetDenseStorage(IsDenseStorage());
+    scene->SetRoot(std::move(root));
+    scene->SetPath(GetPath());
+    return scene;
+}
+
+std::unique_ptr<Entity> Scene::InstantiateRoot() const {
+    CLEAVE_PROFILE_SCOPE("Scene::Instantiate");
+    if (!m_prototype) {
+        if (!m_root) return nullptr;
+        CLEAVE_PROFILE_SCOPE("Scene::BuildPrototype");
+        m_prototype = m_root->Clone();
+    }
+    return m_prototype->Clone();
 }
 
-std::unique_ptr<Entity> Scene::ReleaseRoot() { return std::move(m_root); }
+void Scene::SnapshotPrototype() {
+    CLEAVE_PROFILE_SCOPE("Scene::BuildPrototype");
+    m_prototype = m_root ? m_root->Clone() : nullptr;
+}
+
+std::shared_ptr<Scene> Scene::Clone() const {
+    CLEAVE_PROFILE_SCOPE("Scene::Clone");
+    auto scene = std::make_shared<Scene>();
+    scene->SetDenseStorage(IsDenseStorage());
+    if (m_root) {
+        scene->SetRoot(m_root->Clone());
+    }
+    scene->SetPath(GetPath());
+    return scene;
+}
+
+std::unique_ptr<Entity> Scene::ReleaseRoot() {
+    m_prototype.reset();
+    if (m_root) {
+        m_root->AttachStorage(nullptr);
+        m_root->AttachIndex(nullptr);
+    }
+    return std::move(m_root);
+}
 
 Entity* Scene::GetRoot() const { return m_root.get(); }
-void Scene::SetRoot(std::unique_ptr<Entity> root) { m_root = std::move(root); }
+void Scene::SetRoot(std::unique_ptr<Entity> root) {
+    m_prototype.reset();
+    if (m_root) {
+        m_root->AttachIndex(nullptr);
+    }
+    m_root = std::move(root);
+    if (m_root) {
+        m_root->AttachStorage(m_storage.get());
+        m_root->AttachIndex(&m_index);
+    }
+}
 
 void Scene::AddSubScene(std::shared_ptr<Scene> subScene) {
     if (!subScene || !subScene->GetRoot()) {
         LOG_ERROR("Failed to load sub scene" << subScene->GetPath());
         return;
     }
-    subScene = subScene->Instantiate();
+    m_root->AddChild(subScene->InstantiateRoot());
+}
 
-    m_root->AddChild(subScene->ReleaseRoot());
+std::shared_ptr<SceneLoad> Scene::AddSubSceneAsync(const std::string& path) {
+    std::shared_ptr<SceneLoad> load = SceneLoader::LoadAsync(path);
+    m_subSceneLoads.push_back(load);
+    return load;
 }
 
-void Scene::Clear() { m_root.release(); }
+void Scene::AttachLoadedSubScenes() {
+    for (size_t i = 0; i < m_subSceneLoads.size();) {
+        SceneLoad& load = *m_subSceneLoads[i];
+        if (!load.IsReady()) {
+            i++;
+            continue;
+        }
 
-void Scene::Tick() {
+        std::shared_ptr<Scene> subScene = load.TakeScene();
+        if (subScene && subScene->GetRoot()) {
+            m_root->AddChild(subScene->ReleaseRoot());
+        }
+        m_subSceneLoads.erase(m_subSceneLoads.begin() + i);
+    }
+}
+
+Entity* Scene::GetEntity(EntityId id) const { return m_index.Find(id); }
+
+void Scene::Clear() {
+    m_prototype.reset();
     if (m_root) {
-        m_root->Tick(16.6666f);
+        m_root->AttachStorage(nullptr);
+        m_root->AttachIndex(nullptr);
     }
+    m_root.release();
 }
-void Scene::Render(Renderer* renderer) {
+
+bool Scene::IsDenseStorage() const { return m_storage != nullptr; }
+void Scene::SetDenseStorage(bool dense) {
+    if (dense == IsDenseStorage()) return;
+
+    std::unique_ptr<EntityStorage> storage = dense ? std::make_unique<EntityStorage>() : nullptr;
     if (m_root) {
-        m_root->Render(renderer);
+        m_root->AttachStorage(storage.get());
+    }
+    m_storage = std::move(storage);
+}
+
+void Scene::Tick(float deltaTime) {
+    CLEAVE_PROFILE_SCOPE("Scene::Tick");
+    if (!m_root) return;
+
+    if (!m_subSceneLoads.empty()) {
+        AttachLoadedSubScenes();
+    }
+
+    if (m_storage) {
+        CLEAVE_PROFILE_SCOPE("EntityStorage::TickAnimations");
+        m_storage->TickAnimations(deltaTime);
+    }
+
+    JobSystem* jobs = Services::IsProvided<JobSystem>() ? GET_JOBSYSTEM() : nullptr;
+    if (m_parallelTick && jobs && jobs->GetWorkerCount() > 0) {
+        TickParallel(jobs, deltaTime);
+    } else {
+        m_root->Tick(deltaTime);
+    }
+}
+
+bool Scene::IsParallelTickEnabled() const { return m_parallelTick; }
+void Scene::SetParallelTickEnabled(bool enabled) { m_parallelTick = enabled; }
+
+void Scene::TickParallel(JobSystem* jobs, float deltaTime) {
+    m_tickNodes.clear();
+    MeasureTick(m_root.get());
+    const uint32_t total = m_tickNodes[0].size;
+    if (total < PARALLEL_TICK_MIN_ENTITIES) {
+        m_root->Tick(deltaTime);
+        return;
+    }
+
+    m_tickSteps.clear();
+    m_tickRoots.clear();
+    const uint32_t grain = std::max(PARALLEL_TICK_MIN_GRAIN, total / ((jobs->GetWorkerCount() + 1) * 4));
+    uint32_t index = 0;
+    uint32_t batchSize = 0;
+    PlanTick(m_root.get(), index, grain, batchSize);
+
+    // Tasks share their ancestors' transforms, so world queries mustn't refresh caches until they're done
+    JobSystem::TaskGroup group;
+    Transform::BeginParallelPhase();
+    for (const TickStep& step : m_tickSteps) {
+        if (step.entity) {
+            step.entity->GetTransform().SavePrevious();
+            step.entity->OnTick(deltaTime);
+            continue;
+        }
+
+        jobs->Run(group, [this, step, deltaTime] {
+            CLEAVE_PROFILE_SCOPE("Scene::TickTask");
+            for (uint32_t i = step.first; i < step.first + step.count; i++) {
+                m_tickRoots[i]->Tick(deltaTime);
+            }
+        });
     }
+    jobs->Wait(group);
+    Transform::EndParallelPhase();
+}
+
+void Scene::MeasureTick(Entity* entity) {
+    const size_t index = m_tickNodes.size();
+    m_tickNodes.push_back({1, entity->CanTickInParallel()});
+    for (const auto& child : entity->GetChildren()) {
+        const size_t childIndex = m_tickNodes.size();
+        MeasureTick(child.get());
+        m_tickNodes[index].size += m_tickNodes[childIndex].size;
+        m_tickNodes[index].parallel = m_tickNodes[index].parallel && m_tickNodes[childIndex].parallel;
+    }
+}
+
+void Scene::PlanTick(Entity* entity, uint32_t& index, uint32_t grain, uint32_t& batchSize) {
+    const TickNode node = m_tickNodes[index];
+    if (node.parallel && node.size <= grain) {
+        // Consecutive small subtrees share a task until it holds a grain's worth of entities
+        if (m_tickSteps.empty() || m_tickSteps.back().entity || batchSize + node.size > grain) {
+            m_tickSteps.push_back({nullptr, static_cast<uint32_t>(m_tickRoots.size()), 0});
+            batchSize = 0;
+        }
+        m_tickRoots.push_back(entity);
+        m_tickSteps.back().count++;
+        batchSize += node.size;
+        index += node.size;
+        return;
+    }
+
+    m_tickSteps.push_back({entity, 0, 0});
+    index++;
+    for (const auto& child : entity->GetChildren()) {
+        PlanTick(child.get(), index, grain, batchSize);
+    }
+}
+void Scene::Render(Renderer* renderer, float alpha) {
+    CLEAVE_PROFILE_SCOPE("Scene::Render");
+    m_renderStats = RenderStats();
+    if (!m_root) return;
+
+    m_blended.clear();
+    if (alpha < 1.0f) {
+        CLEAVE_PROFILE_SCOPE("Scene::BlendTransforms");
+        BlendSubtree(m_root.get(), std::max(alpha, 0.0f));
+    }
+
+    // Indexing below leaves every visible world transform cached, which recording then reads
+    if (m_storage) {
+        CLEAVE_PROFILE_SCOPE("Scene::UpdateTransforms");
+        m_storage->UpdateWorld();
+    }
+
+    {
+        CLEAVE_PROFILE_SCOPE("Scene::UpdateSpatialIndex");
+        m_indexStamp++;
+        m_unbounded.clear();
+        m_hasCameraProjection = false;
+        uint32_t order = 0;
+        IndexSubtree(m_root.get(), renderer, order);
+        m_grid.RemoveStale(m_indexStamp);
+        m_renderStats.visited = order;
+    }
+
+    {
+        CLEAVE_PROFILE_SCOPE("Scene::Cull");
+        // A camera only sets its projection once recording reaches it, so cull with the one
+        // it's going to set rather than whatever the renderer still holds
+        Rect4f view;
+        const Matrix4 projection = m_hasCameraProjection ? m_cameraProjection : renderer->GetProjection();
+        if (!m_cullingEnabled || !GetViewRect(projection, view)) {
+            view = {-1e30f, -1e30f, 2e30f, 2e30f};
+        }
+        m_hits.clear();
+        m_grid.Query(view, m_hits);
+
+        // Hits carry their pre-order number, so merging them with the unbounded entities
+        // restores the order a plain tree walk would draw in
+        auto byOrder = [](const SpatialGrid::Hit& a, const SpatialGrid::Hit& b) { return a.order < b.order; };
+        std::sort(m_hits.begin(), m_hits.end(), byOrder);
+        m_renderList.clear();
+        std::merge(m_hits.begin(), m_hits.end(), m_unbounded.begin(), m_unbounded.end(),
+                   std::back_inserter(m_renderList), byOrder);
+
+        m_renderStats.culled = m_grid.GetCount() - static_cast<uint32_t>(m_hits.size());
+        m_renderStats.rendered = static_cast<uint32_t>(m_renderList.size());
+    }
+
+    RecordRenderList(renderer);
+
+    // Hand the simulation its own state back
+    for (const BlendedTransform& blended : m_blended) {
+        blended.transform->SetPosition(blended.position);
+        blended.transform->SetScale(blended.scale);
+        blended.transform->SetRotation(blended.rotation);
+    }
+}
+
+void Scene::RecordRenderList(Renderer* renderer) {
+    const size_t count = m_renderList.size();
+    JobSystem* jobs = Services::IsProvided<JobSystem>() ? GET_JOBSYSTEM() : nullptr;
+    // Buckets start from the state before recording rather than where the previous bucket
+    // left off, which only matches recording on one thread when nothing relies on the latter
+    auto selfContained = [](const SpatialGrid::Hit& hit) { return hit.entity->IsRenderStateSelfContained(); };
+    if (!jobs || jobs->GetWorkerCount() == 0 || count < PARALLEL_RENDER_MIN_ENTITIES ||
+        !std::all_of(m_renderList.begin(), m_renderList.end(), selfContained)) {
+        for (const SpatialGrid::Hit& hit : m_renderList) {
+            hit.entity->OnRender(renderer);
+        }
+        return;
+    }
+
+    // Each bucket records a contiguous run of the list, so appending the buckets in order
+    // gives the same command order as recording it on one thread
+    const uint32_t bucketCount = static_cast<uint32_t>(std::min<size_t>(count, (jobs->GetWorkerCount() + 1) * 4));
+    renderer->BeginBuckets(bucketCount);
+    const uint64_t changeEpoch = Transform::GetChangeEpoch();
+    Transform::BeginParallelPhase();
+    jobs->ParallelFor(bucketCount, [&](uint32_t bucket) {
+        CLEAVE_PROFILE_SCOPE("Scene::RecordBucket");
+        size_t begin = count * bucket / bucketCount;
+        size_t end = count * (bucket + 1) / bucketCount;
+        renderer->BeginBucket(bucket);
+        for (size_t i = begin; i < end; i++) {
+            m_renderList[i].entity->OnRender(renderer);
+        }
+        renderer->EndBucket();
+    });
+    Transform::EndParallelPhase();
+    if (Transform::GetChangeEpoch() != changeEpoch) {
+        LOG_ERROR("A transform changed while recording in parallel; OnRender must not move entities");
+    }
+    renderer->EndBuckets();
+}
+
+void Scene::BlendSubtree(Entity* entity, float alpha) {
+    if (!entity->IsVisible()) return;
+
+    Transform& transform = entity->GetTransform();
+    const BlendedTransform simulated = {&transform, transform.GetPosition(), transform.GetScale(), transform.GetRotation()};
+    if (transform.BlendFromPrevious(alpha)) {
+        m_blended.push_back(simulated);
+    }
+
+    for (const auto& child : entity->GetChildren()) {
+        BlendSubtree(child.get(), alpha);
+    }
+}
+
+void Scene::IndexSubtree(Entity* entity, Renderer* renderer, uint32_t& order) {
+    if (!m_storage) {
+        entity->GetTransform().UpdateWorldTransform();
+    }
+    // Hidden subtrees aren't indexed, so they drop out of the grid until shown again
+    if (!entity->IsVisible()) return;
+
+    entity->OnPreRender();
+    const uint32_t index = order++;
+    Rect4f bounds;
+    if (entity->GetWorldBounds(bounds)) {
+        m_grid.Update(entity, bounds, index, m_indexStamp);
+    } else {
+        m_unbounded.push_back({index, entity});
+    }
+    // Recording goes in this same order, so the last camera's projection is the one that sticks
+    if (entity->GetProjection(renderer, m_cameraProjection)) {
+        m_hasCameraProjection = true;
+    }
+
+    for (const auto& child : entity->GetChildren()) {
+        IndexSubtree(child.get(), renderer, order);
+    }
+}
+
+bool Scene::IsCullingEnabled() const { return m_cullingEnabled; }
+void Scene::SetCullingEnabled(bool enabled) { m_cullingEnabled = enabled; }
+
+const Scene::RenderStats& Scene::GetRenderStats() const { return m_renderStats; }
+
+std::shared_ptr<SceneLoad> SceneLoader::LoadAsync(const std::string& path) {
+    return std::make_shared<SceneLoad>(path);
 }
 
 std::shared_ptr<Resource> SceneLoader::Load(const std::string& path, ResourceManager* resourceManager) {
-    auto scene = JsonSceneSerializer::Load(path);
+    // Async loads don't pass a resource manager, but still have to see a mounted archive
+    if (!resourceManager && Services::IsProvided<ResourceManager>()) {
+        resourceManager = GET_RESMGR();
+    }
+
+    const bool binary = std::filesystem::path(path).extension() == ".bscn";
+    std::shared_ptr<Scene> scene;
+    if (resourceManager) {
+        ResourceData data;
+        if (!resourceManager->ReadResource(path, data)) {
+            LOG_ERROR("Failed to open: " << path);
+            return nullptr;
+        }
+        scene = binary ? BinarySceneSerializer::LoadFromMemory(data.GetBytes(), path)
+                       : JsonSceneSerializer::LoadFromMemory(data.GetText());
+    } else {
+        scene = binary ? BinarySceneSerializer::Load(path) : JsonSceneSerializer::Load(path);
+    }
+    if (!scene) return nullptr;
     scene->SetPath(path);
+    // Async loads still have resources to assign on the main thread, so this queues up behind them
+    SceneLoad::RunOnMainThread([scene] { scene->SnapshotPrototype(); });
     return scene;
 }
 }  // namespace Cleave
\ No newline at end of file
@@ -3,37 +3,151 @@
 
 #include "entities/Entity.hpp"
 #include "resources/Resource.hpp"
+#include "scene/EntityIndex.hpp"
+#include "scene/EntityStorage.hpp"
+#include "scene/SpatialGrid.hpp"
 
 namespace Cleave {
+class JobSystem;
+class SceneLoad;
+
 class Scene : public Resource {
 public:
-    Scene(std::unique_ptr<Entity> root = nullptr) : m_root(std::move(root)) {}
+    Scene(std::unique_ptr<Entity> root = nullptr);
     ~Scene() = default;
 
-    std::string_view GetTypeName() const override { return "cleave::Scene"; }
+    static constexpr std::string_view TYPE_NAME = "cleave::Scene";
+    std::string_view GetTypeName() const override { return TYPE_NAME; }
 
+    // Copies of this scene's tree built from an in-memory prototype. Loaded scenes snapshot it
+    // as soon as the tree is built; others the first time either is called. Every copy gets
+    // fresh entity ids.
     std::shared_ptr<Scene> Instantiate() const;
+    std::unique_ptr<Entity> InstantiateRoot() const;
+    // Replaces the prototype with a copy of the tree as it is now
+    void SnapshotPrototype();
+
+    // Copy of the tree as it is now, with fresh entity ids
+    std::shared_ptr<Scene> Clone() const;
 
     std::unique_ptr<Entity> ReleaseRoot();
     Entity* GetRoot() const;
     void SetRoot(std::unique_ptr<Entity> root);
 
     void AddSubScene(std::shared_ptr<Scene> subScene);
+    // Loads `path` in the background and adds its root under this scene's root at the start
+    // of the first Tick after it's ready. The returned load is for watching progress.
+    std::shared_ptr<SceneLoad> AddSubSceneAsync(const std::string& path);
+
+    // Any entity in the tree, including the root
+    Entity* GetEntity(EntityId id) const;
 
     void Clear();
 
-    void Tick();
-    void Render(Renderer* renderer);
+    // Dense mode keeps the hot per-entity data of the whole tree in packed arrays that are
+    // updated in linear passes; entities stay usable through the same API either way
+    bool IsDenseStorage() const;
+    void SetDenseStorage(bool dense);
+
+    // Advances the simulation by one step of `deltaTime` seconds
+    void Tick(float deltaTime);
+
+    // Splits the tree into subtree tasks on the job system. Subtrees containing an entity
+    // that can't tick in parallel are walked on the calling thread instead, and ancestors
+    // always tick before their descendants, so the result matches the serial tick as long
+    // as ticks don't reach across subtrees or restructure the tree.
+    bool IsParallelTickEnabled() const;
+    void SetParallelTickEnabled(bool enabled);
+    // Draws the entities whose bounds overlap the view of the renderer's current projection,
+    // in tree order. Below 1, `alpha` blends every transform between its state before and
+    // after the last Tick for the duration of the call.
+    void Render(Renderer* renderer, float alpha = 1.0f);
+
+    struct RenderStats {
+        uint32_t visited = 0;   // Visible entities walked to refresh the spatial index
+        uint32_t culled = 0;    // Bounded entities skipped for lying outside the view
+        uint32_t rendered = 0;  // Entities whose OnRender ran
+    };
+    const RenderStats& GetRenderStats() const;
+
+    bool IsCullingEnabled() const;
+    void SetCullingEnabled(bool enabled);
 
 private:
+    // Below this many entities to draw recording isn't worth splitting across threads
+    static constexpr size_t PARALLEL_RENDER_MIN_ENTITIES = 256;
+
+    // Below this many entities the tick isn't worth splitting across threads
+    static constexpr uint32_t PARALLEL_TICK_MIN_ENTITIES = 256;
+    // Smallest number of entities handed to one tick task
+    static constexpr uint32_t PARALLEL_TICK_MIN_GRAIN = 32;
+
+    // Pre-order subtree summary used to plan a parallel tick
+    struct TickNode {
+        uint32_t size = 1;
+        bool parallel = true;  // Every entity in the subtree can tick on a worker
+    };
+
+    // One step of a parallel tick plan, executed in order by the ticking thread. Either an
+    // entity ticked in place, or a task ticking the subtrees m_tickRoots[first, first + count)
+    struct TickStep {
+        Entity* entity = nullptr;
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    void AttachLoadedSubScenes();
+    void TickParallel(JobSystem* jobs, float deltaTime);
+    void MeasureTick(Entity* entity);
+    void PlanTick(Entity* entity, uint32_t& index, uint32_t grain, uint32_t& batchSize);
+
+    void IndexSubtree(Entity* entity, Renderer* renderer, uint32_t& order);
+    void BlendSubtree(Entity* entity, float alpha);
+    void RecordRenderList(Renderer* renderer);
+
+    // Simulated local values of a transform that is showing a blended state during Render
+    struct BlendedTransform {
+        Transform* transform;
+        Vec2f position;
+        Vec2f scale;
+        float rotation;
+    };
+
+    std::vector<std::shared_ptr<SceneLoad>> m_subSceneLoads;
+
+    bool m_parallelTick = false;
+    std::vector<TickNode> m_tickNodes;
+    std::vector<TickStep> m_tickSteps;
+    std::vector<Entity*> m_tickRoots;
+
+    std::vector<BlendedTransform> m_blended;
+
+    SpatialGrid m_grid;
+    std::vector<SpatialGrid::Hit> m_unbounded;
+    std::vector<SpatialGrid::Hit> m_hits;
+    Matrix4 m_cameraProjection;
+    bool m_hasCameraProjection = false;
+    std::vector<SpatialGrid::Hit> m_renderList;
+    uint32_t m_indexStamp = 0;
+    bool m_cullingEnabled = true;
+    RenderStats m_renderStats;
+
+    mutable std::unique_ptr<Entity> m_prototype;
+
+    // Declared first so the tree, whose entities unregister themselves, is destroyed before them
+    EntityIndex m_index;
+    std::unique_ptr<EntityStorage> m_storage;
     std::unique_ptr<Entity> m_root;
 };
 
 class SceneLoader : public ResourceLoader {
 public:
     std::shared_ptr<Resource> Load(const std::string& path, ResourceManager* resourceManager) override;
+    // Reads, parses and builds the scene on a background thread; see SceneLoad
+    static std::shared_ptr<SceneLoad> LoadAsync(const std::string& path);
+    std::string_view GetResourceTypeName() const override { return Scene::TYPE_NAME; }
     bool CanLoad(const std::string_view extension) const override {
-        return extension == ".jscn";
+        return extension == ".jscn" || extension == ".bscn";
     }
 };
 }  // namespace Cleave
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "scene/SceneLoad.hpp"
+
+#include "scene/Scene.hpp"
+#include "profiling/Profiler.hpp"
+#include "Log.hpp"
+
+namespace Cleave {
+thread_local SceneLoad* SceneLoad::s_current = nullptr;
+
+SceneLoad::SceneLoad(const std::string& path) : m_path(path) {
+    m_thread = std::thread([this] { Run(); });
+}
+
+SceneLoad::~SceneLoad() {
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+const std::string& SceneLoad::GetPath() const { return m_path; }
+
+float SceneLoad::GetProgress() const { return m_progress.load(std::memory_order_relaxed); }
+bool SceneLoad::IsReady() const { return m_ready.load(std::memory_order_acquire); }
+bool SceneLoad::HasFailed() const { return IsReady() && m_failed; }
+
+std::shared_ptr<Scene> SceneLoad::TakeScene() {
+    if (!IsReady() || m_failed || m_taken) return nullptr;
+
+    CLEAVE_PROFILE_SCOPE("SceneLoad::TakeScene");
+    m_taken = true;
+    for (size_t i = 0; i < m_mainThreadSteps.size(); i++) {
+        const MainThreadStep& step = m_mainThreadSteps[i];
+        if (step.owner) {
+            auto dropped = m_droppedOwners.find(step.owner);
+            if (dropped != m_droppedOwners.end() && i < dropped->second) continue;
+        }
+        step.run();
+    }
+    m_mainThreadSteps.clear();
+    m_droppedOwners.clear();
+    return std::move(m_scene);
+}
+
+void SceneLoad::RunOnMainThread(std::function<void()> step) {
+    if (s_current) {
+        s_current->m_mainThreadSteps.push_back({nullptr, std::move(step)});
+    } else {
+        step();
+    }
+}
+
+void SceneLoad::RunOnMainThread(const Entity& owner, std::function<void()> step) {
+    if (s_current) {
+        s_current->m_mainThreadSteps.push_back({&owner, std::move(step)});
+    } else {
+        step();
+    }
+}
+
+void SceneLoad::DropSteps(const Entity& owner) {
+    // Entities of a loading scene are only ever destroyed on its thread before it's taken
+    if (s_current && !s_current->m_mainThreadSteps.empty()) {
+        s_current->m_droppedOwners[&owner] = s_current->m_mainThreadSteps.size();
+    }
+}
+
+void SceneLoad::ReportProgress(float progress) {
+    if (s_current) {
+        s_current->m_progress.store(progress, std::memory_order_relaxed);
+    }
+}
+
+void SceneLoad::Run() {
+    CLEAVE_PROFILE_THREAD("Scene Loader");
+    CLEAVE_PROFILE_SCOPE("SceneLoad::Run");
+    s_current = this;
+    try {
+        m_scene = std::dynamic_pointer_cast<Scene>(SceneLoader().Load(m_path, nullptr));
+    } catch (const std::exception& e) {
+        LOG_ERROR("Scene loading failed: " << e.what());
+        m_scene = nullptr;
+    }
+    s_current = nullptr;
+
+    if (!m_scene) {
+        LOG_ERROR("Failed to load scene " << m_path);
+        m_failed = true;
+        m_mainThreadSteps.clear();
+        m_droppedOwners.clear();
+    }
+    m_progress.store(1.0f, std::memory_order_relaxed);
+    m_ready.store(true, std::memory_order_release);
+}
+}  // namespace Cleave
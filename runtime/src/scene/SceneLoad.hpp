@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Cleave {
+class Entity;
+class Scene;
+
+// A scene read, parsed and built on its own background thread. Steps that have to run on the
+// main (render) thread are queued while it builds and run in TakeScene, just before the
+// finished scene is handed over, so callers can swap it in between two frames.
+class SceneLoad {
+public:
+    explicit SceneLoad(const std::string& path);
+    // Waits for the background thread if it's still loading. Steps of a scene that was never
+    // taken are dropped without running.
+    ~SceneLoad();
+
+    SceneLoad(const SceneLoad& other) = delete;
+    SceneLoad& operator=(const SceneLoad& other) = delete;
+
+    const std::string& GetPath() const;
+
+    // 0 to 1, advancing as the file is read and its entities are built
+    float GetProgress() const;
+    // Whether the background work has finished, successfully or not
+    bool IsReady() const;
+    bool HasFailed() const;
+
+    // Main thread only. Once ready, runs the queued main-thread steps and returns the scene.
+    // Returns null while loading, after a failure, and on every call after the first success.
+    std::shared_ptr<Scene> TakeScene();
+
+    // For serializers and property setters. On a loading thread these act on its load;
+    // anywhere else `step` runs right away and progress goes nowhere.
+    static void RunOnMainThread(std::function<void()> step);
+    // Same, for steps that act on `owner`: they're dropped if it's destroyed before they run
+    static void RunOnMainThread(const Entity& owner, std::function<void()> step);
+    static void ReportProgress(float progress);
+
+    // Called by entities as they're destroyed
+    static void DropSteps(const Entity& owner);
+
+private:
+    struct MainThreadStep {
+        const Entity* owner = nullptr;
+        std::function<void()> run;
+    };
+
+    void Run();
+
+    std::string m_path;
+    std::atomic<float> m_progress{0.0f};
+    std::atomic<bool> m_ready{false};
+    // Written by the loading thread before it sets m_ready, owned by the main thread after
+    std::shared_ptr<Scene> m_scene;
+    std::vector<MainThreadStep> m_mainThreadSteps;
+    // Destroyed owners and how many steps were queued by then. A later entity at the same
+    // address only queues steps after that count, so those still run.
+    std::unordered_map<const Entity*, size_t> m_droppedOwners;
+    bool m_failed = false;
+    bool m_taken = false;
+    std::thread m_thread;
+
+    static thread_local SceneLoad* s_current;
+};
+}  // namespace Cleave
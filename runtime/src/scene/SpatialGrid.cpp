@@ -0,0 +1,154 @@
+#include "scene/SpatialGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Cleave {
+void SpatialGrid::Update(Entity* entity, const Rect4f& bounds, uint32_t order, uint32_t stamp) {
+    uint32_t index;
+    auto it = m_lookup.find(entity);
+    if (it == m_lookup.end()) {
+        if (!m_free.empty()) {
+            index = m_free.back();
+            m_free.pop_back();
+        } else {
+            index = static_cast<uint32_t>(m_entries.size());
+            m_entries.emplace_back();
+        }
+        m_entries[index] = Entry();
+        m_entries[index].entity = entity;
+        m_lookup.emplace(entity, index);
+    } else {
+        index = it->second;
+    }
+
+    Entry& entry = m_entries[index];
+    entry.bounds = bounds;
+    entry.order = order;
+    entry.stamp = stamp;
+
+    const int x0 = CellCoord(bounds.x);
+    const int y0 = CellCoord(bounds.y);
+    const int x1 = CellCoord(bounds.x + bounds.w);
+    const int y1 = CellCoord(bounds.y + bounds.h);
+    const bool large = static_cast<int64_t>(x1 - x0 + 1) * (y1 - y0 + 1) > MAX_ENTRY_CELLS;
+    if (large == entry.large && (large || (x0 == entry.x0 && y0 == entry.y0 && x1 == entry.x1 && y1 == entry.y1))) {
+        return;
+    }
+
+    Unlink(index);
+    entry.x0 = x0;
+    entry.y0 = y0;
+    entry.x1 = x1;
+    entry.y1 = y1;
+    entry.large = large;
+    Link(index);
+}
+
+void SpatialGrid::RemoveStale(uint32_t stamp) {
+    if (m_lookup.empty()) return;
+
+    for (uint32_t index = 0; index < m_entries.size(); index++) {
+        Entry& entry = m_entries[index];
+        if (!entry.entity || entry.stamp == stamp) continue;
+
+        Unlink(index);
+        m_lookup.erase(entry.entity);
+        entry.entity = nullptr;
+        m_free.push_back(index);
+    }
+}
+
+void SpatialGrid::Query(const Rect4f& rect, std::vector<Hit>& hits) {
+    m_queryStamp++;
+
+    auto test = [&](uint32_t index) {
+        Entry& entry = m_entries[index];
+        if (entry.queryStamp == m_queryStamp) return;
+        entry.queryStamp = m_queryStamp;
+        if (entry.bounds.Overlaps(rect)) {
+            hits.push_back({entry.order, entry.entity});
+        }
+    };
+
+    for (uint32_t index : m_large) {
+        test(index);
+    }
+
+    const int x0 = CellCoord(rect.x);
+    const int y0 = CellCoord(rect.y);
+    const int x1 = CellCoord(rect.x + rect.w);
+    const int y1 = CellCoord(rect.y + rect.h);
+
+    // A view wider than the populated grid is cheaper to answer by walking the cells
+    if (static_cast<int64_t>(x1 - x0 + 1) * (y1 - y0 + 1) > static_cast<int64_t>(m_cells.size())) {
+        for (const auto& [key, cell] : m_cells) {
+            for (uint32_t index : cell) {
+                test(index);
+            }
+        }
+        return;
+    }
+
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            auto it = m_cells.find(MakeKey(x, y));
+            if (it == m_cells.end()) continue;
+            for (uint32_t index : it->second) {
+                test(index);
+            }
+        }
+    }
+}
+
+uint32_t SpatialGrid::GetCount() const { return static_cast<uint32_t>(m_lookup.size()); }
+
+int SpatialGrid::CellCoord(float position) {
+    // Clamped so far-off or degenerate boxes can't overflow the cell math
+    const float cell = std::floor(position / CELL_SIZE);
+    return static_cast<int>(std::clamp(cell, -1048576.0f, 1048576.0f));
+}
+
+uint64_t SpatialGrid::MakeKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void SpatialGrid::Link(uint32_t index) {
+    const Entry& entry = m_entries[index];
+    if (entry.large) {
+        m_large.push_back(index);
+        return;
+    }
+    for (int y = entry.y0; y <= entry.y1; y++) {
+        for (int x = entry.x0; x <= entry.x1; x++) {
+            m_cells[MakeKey(x, y)].push_back(index);
+        }
+    }
+}
+
+void SpatialGrid::Unlink(uint32_t index) {
+    const Entry& entry = m_entries[index];
+    auto unlinkFrom = [index](std::vector<uint32_t>& list) {
+        auto it = std::find(list.begin(), list.end(), index);
+        if (it != list.end()) {
+            *it = list.back();
+            list.pop_back();
+        }
+    };
+
+    if (entry.large) {
+        unlinkFrom(m_large);
+        return;
+    }
+    for (int y = entry.y0; y <= entry.y1; y++) {
+        for (int x = entry.x0; x <= entry.x1; x++) {
+            auto it = m_cells.find(MakeKey(x, y));
+            if (it == m_cells.end()) continue;
+            unlinkFrom(it->second);
+            if (it->second.empty()) {
+                m_cells.erase(it);
+            }
+        }
+    }
+}
+}  // namespace Cleave
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "math/Rect4.hpp"
+
+namespace Cleave {
+class Entity;
+
+// Hashed grid of world-space bounding boxes. Entities are re-binned only when their box
+// moves to a different range of cells; boxes too large for the grid go to a list that every
+// query tests directly.
+class SpatialGrid {
+public:
+    static constexpr float CELL_SIZE = 256.0f;
+    static constexpr int MAX_ENTRY_CELLS = 64;
+
+    struct Hit {
+        uint32_t order;
+        Entity* entity;
+    };
+
+    // Inserts or moves `entity`. `stamp` marks it as seen for RemoveStale, `order` is handed
+    // back with query hits
+    void Update(Entity* entity, const Rect4f& bounds, uint32_t order, uint32_t stamp);
+    // Drops every entity that wasn't updated with `stamp`
+    void RemoveStale(uint32_t stamp);
+    // Appends every entity whose box overlaps `rect`, each once, in no particular order
+    void Query(const Rect4f& rect, std::vector<Hit>& hits);
+    uint32_t GetCount() const;
+
+private:
+    struct Entry {
+        Entity* entity = nullptr;
+        Rect4f bounds = {};
+        int x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+        bool large = false;
+        uint32_t order = 0;
+        uint32_t stamp = 0;
+        uint32_t queryStamp = 0;
+    };
+
+    static int CellCoord(float position);
+    static uint64_t MakeKey(int x, int y);
+    void Link(uint32_t index);
+    void Unlink(uint32_t index);
+
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_free;
+    std::unordered_map<Entity*, uint32_t> m_lookup;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+    std::vector<uint32_t> m_large;
+    uint32_t m_queryStamp = 0;
+};
+}  // namespace Cleave
@@ -1,8 +1,24 @@
 #include "services/AudioManager.hpp"
 
+#include "profiling/Profiler.hpp"
+
 namespace Cleave {
+    bool AudioManager::LoadSound(const std::shared_ptr<Sound>& sound) {
+        if (!sound) return false;
+        if (sound->GetData()) return true;
+
+        CLEAVE_PROFILE_SCOPE("AudioManager::LoadSound");
+        ResourceData data;
+        if (!m_resourceManager->ReadResource(sound->GetPath(), data)) {
+            LOG_ERROR("Failed to read sound: " << sound->GetPath());
+            return false;
+        }
+        return m_backend->LoadSound(sound, data.GetBytes());
+    }
+
     SoundHandle AudioManager::PlaySound(std::shared_ptr<Sound> sound) {
-        if (m_backend) {
+        CLEAVE_PROFILE_SCOPE("AudioManager::PlaySound");
+        if (m_backend && LoadSound(sound)) {
             return m_backend->PlaySound(sound, m_soundVolume);
         }
 
@@ -10,18 +26,21 @@ namespace Cleave {
     }
 
     void AudioManager::StopSound(SoundHandle handle) {
+        CLEAVE_PROFILE_SCOPE("AudioManager::StopSound");
         if (m_backend) {
             m_backend->StopSound(handle);
         }
     }
 
     void AudioManager::PlayMusic(std::shared_ptr<Sound> music) {
-        if (m_backend) {
+        CLEAVE_PROFILE_SCOPE("AudioManager::PlayMusic");
+        if (m_backend && LoadSound(music)) {
             m_backend->PlayMusic(music, m_soundVolume);
         }
     }
 
     void AudioManager::StopAllSounds() {
+        CLEAVE_PROFILE_SCOPE("AudioManager::StopAllSounds");
         if (m_backend) {
             m_backend->StopAllSounds();
         }
@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <span>
 
 #include "services/ResourceManager.hpp"
 #include "resources/Sound.hpp"
@@ -17,7 +18,8 @@ public:
     virtual bool Init() = 0;
     virtual void Shutdown() = 0;
     
-    virtual bool LoadSound(std::shared_ptr<Sound> sound) = 0;
+    // Decodes a sound file's bytes, which are only read during the call
+    virtual bool LoadSound(std::shared_ptr<Sound> sound, std::span<const uint8_t> data) = 0;
     virtual SoundHandle PlaySound(std::shared_ptr<Sound> sound, float volume = 1.0f) = 0;
     virtual void StopSound(SoundHandle handle) = 0;
 
@@ -57,6 +59,9 @@ public:
 
     void SetSoundLoop(SoundHandle handle, bool loop);
 private:
+    // Reads the sound through the resource manager and hands it to the backend the first time it plays
+    bool LoadSound(const std::shared_ptr<Sound>& sound);
+
     std::unique_ptr<AudioBackend> m_backend;
     ResourceManager* m_resourceManager;
     float m_musicVolume = 1.0f;
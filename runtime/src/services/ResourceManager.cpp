@@ -1,11 +1,79 @@
 #include "services/ResourceManager.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <fstream>
+#include <mutex>
 
+#include "jobs/JobSystem.hpp"
 #include "rendering/Renderer.hpp"
+#include "profiling/Profiler.hpp"
 
 namespace Cleave {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+float MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+// Workers push finished preparations, the GL thread pops and completes them as they arrive
+class CompletionQueue {
+public:
+    struct Item {
+        size_t file = 0;
+        ResourceLoader::Completion completion;
+    };
+
+    explicit CompletionQueue(size_t expected) : m_remaining(expected) {}
+
+    void Push(Item item) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_items.push_back(std::move(item));
+            m_remaining--;
+        }
+        m_ready.notify_one();
+    }
+
+    // Blocks until an item is ready. Returns false once every expected item was popped.
+    bool Pop(Item& item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_ready.wait(lock, [this] { return !m_items.empty() || m_remaining == 0; });
+        if (m_items.empty()) return false;
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<Item> m_items;
+    size_t m_remaining;
+};
+}  // namespace
+
+struct ResourceManager::LoadBatch {
+    enum class State : uint8_t { Pending, Completing, Done };
+
+    explicit LoadBatch(const std::vector<const ManifestEntry*>& entries, LoadBatch* outer)
+        : entries(entries), completions(entries.size()), states(entries.size(), State::Pending), outer(outer) {
+        for (size_t i = 0; i < entries.size(); i++) {
+            indices.emplace(entries[i]->path, i);
+        }
+    }
+
+    const std::vector<const ManifestEntry*>& entries;
+    std::unordered_map<std::string_view, size_t> indices;
+    CompletionQueue completions;
+    std::vector<State> states;
+    LoadBatch* outer;
+    float uploadMs = 0.0f;
+};
 
 void ResourceManager::RegisterLoader(std::unique_ptr<ResourceLoader> loader) {
     if (loader) {
@@ -13,27 +81,252 @@ void ResourceManager::RegisterLoader(std::unique_ptr<ResourceLoader> loader) {
     }
 }
 
+bool ResourceManager::MountArchive(const std::string& path) {
+    if (!m_archive.Open(path)) return false;
+    m_archiveModified = std::filesystem::last_write_time(path);
+    return true;
+}
+
+bool ResourceManager::HasArchive() const { return m_archive.IsOpen(); }
+
+bool ResourceManager::ReadResource(const std::string& path, ResourceData& data) const {
+    if (const PackArchive::Entry* entry = m_archive.IsOpen() ? m_archive.Find(path) : nullptr) {
+        return m_archive.Read(*entry, data);
+    }
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    std::vector<uint8_t> buffer(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) return false;
+    data = ResourceData(std::move(buffer));
+    return true;
+}
+
+bool ResourceManager::GetModifiedTime(const std::string& path, std::filesystem::file_time_type& time) const {
+    if (m_archive.IsOpen() && m_archive.Find(path)) {
+        time = m_archiveModified;
+        return true;
+    }
+
+    std::error_code error;
+    time = std::filesystem::last_write_time(path, error);
+    return !error;
+}
+
+bool ResourceManager::IsLazyLoading() const { return m_lazyLoading; }
+void ResourceManager::SetLazyLoading(bool lazy) { m_lazyLoading = lazy; }
+
 void ResourceManager::ScanResources(const std::string_view path) {
-    for (const auto& entry :
-         std::filesystem::recursive_directory_iterator(path)) {
-        if (entry.is_regular_file()) {
-            std::string extension = entry.path().extension().string();
-            for (const auto& loader : m_loaders) {
-                if (loader->CanLoad(extension)) {
-                    auto resource = loader->Load(entry.path().generic_string(), this);
-                    if (resource) {
-                        std::string relPath = std::filesystem::relative(entry.path()).generic_string();
-                        m_resources[relPath] = resource;
-                        LOG_INFO("Loaded resource: " << relPath);
-                    }
-                    break;
-                }
+    CLEAVE_PROFILE_SCOPE("ResourceManager::ScanResources");
+    const Clock::time_point scanStart = Clock::now();
+
+    std::vector<const ManifestEntry*> entries;
+    auto addEntry = [this, &entries](const std::string& name, uintmax_t size, std::filesystem::file_time_type modified) {
+        const std::string extension = std::filesystem::path(name).extension().string();
+        for (const auto& loader : m_loaders) {
+            if (loader->CanLoad(extension)) {
+                ManifestEntry& manifestEntry = m_manifest[name];
+                manifestEntry.path = name;
+                manifestEntry.loader = loader.get();
+                manifestEntry.type = loader->GetResourceTypeName();
+                manifestEntry.size = size;
+                manifestEntry.modified = modified;
+                entries.push_back(&manifestEntry);
+                return;
+            }
+        }
+    };
+
+    if (m_archive.IsOpen()) {
+        CLEAVE_PROFILE_SCOPE("ResourceManager::Discover");
+        const std::string prefix = std::filesystem::path(path).generic_string() + "/";
+        for (const PackArchive::Entry& entry : m_archive.GetEntries()) {
+            const std::string_view name = m_archive.GetName(entry);
+            if (name.starts_with(prefix)) {
+                addEntry(std::string(name), entry.size, m_archiveModified);
+            }
+        }
+    } else {
+        CLEAVE_PROFILE_SCOPE("ResourceManager::Discover");
+        for (const auto& entry :
+             std::filesystem::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file()) {
+                addEntry(std::filesystem::relative(entry.path()).generic_string(), entry.file_size(), entry.last_write_time());
+            }
+        }
+    }
+    const float discoverMs = MillisecondsSince(scanStart);
+
+    if (m_lazyLoading) {
+        LOG_INFO("Indexed " << entries.size() << " resources in " << discoverMs << " ms, loading them on demand");
+        return;
+    }
+    LOG_INFO("Found " << entries.size() << " resources in " << discoverMs << " ms");
+    Load(entries);
+}
+
+void ResourceManager::Preload(const std::vector<std::string>& names) {
+    CLEAVE_PROFILE_SCOPE("ResourceManager::Preload");
+    std::vector<const ManifestEntry*> entries;
+    for (const std::string& name : names) {
+        auto it = m_manifest.find(name);
+        if (it == m_manifest.end()) {
+            LOG_WARN("Can't preload '" << name << "', it isn't in the resource manifest");
+        } else if (!IsLoaded(name)) {
+            entries.push_back(&it->second);
+        }
+    }
+    Load(entries);
+}
+
+const std::unordered_map<std::string, ResourceManager::ManifestEntry>& ResourceManager::GetManifest() const {
+    return m_manifest;
+}
+
+bool ResourceManager::IsLoaded(const std::string& name) const {
+    auto it = m_slotIndices.find(name);
+    return it != m_slotIndices.end() && m_slots[it->second].resource;
+}
+
+void ResourceManager::Unload(const std::string& name) {
+    auto it = m_slotIndices.find(name);
+    if (it == m_slotIndices.end() || !m_slots[it->second].resource) return;
+
+    ResourceSlot& slot = m_slots[it->second];
+    slot.resource.reset();
+    slot.generation++;
+}
+
+void ResourceManager::Store(const std::string& name, std::shared_ptr<Resource> resource) {
+    auto it = m_slotIndices.find(name);
+    if (it == m_slotIndices.end()) {
+        it = m_slotIndices.emplace(name, m_slots.Add()).first;
+    }
+    ResourceSlot& slot = m_slots[it->second];
+    slot.resource = std::move(resource);
+    slot.generation++;
+}
+
+bool ResourceManager::Acquire(const std::string& name, uint32_t& slot) {
+    auto it = m_slotIndices.find(name);
+    if (it != m_slotIndices.end() && m_slots[it->second].resource) {
+        slot = it->second;
+        return true;
+    }
+
+    // A completion asking for something its batch is still loading, e.g. a scene for its
+    // textures: finish that entry from the batch rather than decoding and storing it twice
+    for (LoadBatch* batch = m_loadBatch; batch; batch = batch->outer) {
+        auto pending = batch->indices.find(name);
+        if (pending == batch->indices.end()) continue;
+
+        const size_t file = pending->second;
+        while (batch->states[file] == LoadBatch::State::Pending && CompleteNext(*batch)) {}
+        if (batch->states[file] == LoadBatch::State::Completing) {
+            LOG_ERROR("Resource " << name << " depends on itself while loading");
+            return false;
+        }
+        it = m_slotIndices.find(name);
+        if (it == m_slotIndices.end() || !m_slots[it->second].resource) return false;
+        slot = it->second;
+        return true;
+    }
+
+    auto entry = m_manifest.find(name);
+    if (entry == m_manifest.end()) {
+        return false;
+    }
+
+    CLEAVE_PROFILE_SCOPE("ResourceManager::LoadOnDemand");
+    const Clock::time_point loadStart = Clock::now();
+    std::shared_ptr<Resource> resource;
+    try {
+        resource = entry->second.loader->Load(entry->second.path, this);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to load " << entry->second.path << ": " << e.what());
+    }
+    if (!resource) {
+        return false;
+    }
+    Store(name, std::move(resource));
+    LOG_INFO("Loaded resource on demand: " << name << " (" << MillisecondsSince(loadStart) << " ms)");
+    slot = m_slotIndices[name];
+    return true;
+}
+
+void ResourceManager::Load(const std::vector<const ManifestEntry*>& entries) {
+    if (entries.empty()) return;
+
+    // File I/O and decoding run on the job system; everything touching GL is handed back here.
+    // Small textures loaded here are atlased and lose GL_REPEAT, see TextureAtlas.
+    m_textureAtlas.Begin();
+    const Clock::time_point loadStart = Clock::now();
+    LoadBatch batch(entries, m_loadBatch);
+    CompletionQueue& completions = batch.completions;
+    JobSystem* jobs = Services::IsProvided<JobSystem>() ? GET_JOBSYSTEM() : nullptr;
+    JobSystem::TaskGroup group;
+    for (size_t i = 0; i < entries.size(); i++) {
+        auto prepare = [this, &entries, &completions, i] {
+            CLEAVE_PROFILE_SCOPE("ResourceLoader::Prepare");
+            ResourceLoader::Completion completion;
+            try {
+                completion = entries[i]->loader->Prepare(entries[i]->path, this);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Failed to load " << entries[i]->path << ": " << e.what());
             }
+            completions.Push({i, std::move(completion)});
+        };
+        if (jobs) {
+            jobs->Run(group, std::move(prepare));
+        } else {
+            prepare();
         }
     }
+
+    m_loadBatch = &batch;
+    while (CompleteNext(batch)) {}
+    m_loadBatch = batch.outer;
+    if (jobs) {
+        jobs->Wait(group);
+    }
+    const float loadMs = MillisecondsSince(loadStart);
+
+    const Clock::time_point atlasStart = Clock::now();
+    {
+        CLEAVE_PROFILE_SCOPE("TextureAtlas::Build");
+        m_textureAtlas.Build(m_renderer);
+    }
+    const float atlasMs = MillisecondsSince(atlasStart);
+
+    LOG_INFO("Loaded " << entries.size() << " resources in " << loadMs + atlasMs << " ms (load " << loadMs
+             << " ms of which " << batch.uploadMs << " ms on this thread, atlas " << atlasMs << " ms)");
+}
+
+bool ResourceManager::CompleteNext(LoadBatch& batch) {
+    CompletionQueue::Item item;
+    if (!batch.completions.Pop(item)) return false;
+
+    batch.states[item.file] = LoadBatch::State::Completing;
+    if (item.completion) {
+        CLEAVE_PROFILE_SCOPE("ResourceLoader::Complete");
+        // Entries this completion finishes through Acquire add to uploadMs, and are part of its own time
+        const float uploadMs = batch.uploadMs;
+        const Clock::time_point completeStart = Clock::now();
+        auto resource = item.completion();
+        batch.uploadMs = uploadMs + MillisecondsSince(completeStart);
+        if (resource) {
+            Store(batch.entries[item.file]->path, std::move(resource));
+            LOG_INFO("Loaded resource: " << batch.entries[item.file]->path);
+        }
+    }
+    batch.states[item.file] = LoadBatch::State::Done;
+    return true;
 }
 
 Renderer* ResourceManager::GetRenderer() const { return m_renderer; }
 void ResourceManager::SetRenderer(Renderer* renderer) { m_renderer = renderer; }
 
+TextureAtlas& ResourceManager::GetTextureAtlas() { return m_textureAtlas; }
+
 }  // namespace Cleave
\ No newline at end of file
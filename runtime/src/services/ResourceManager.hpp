@@ -5,7 +5,11 @@
 #include <vector>
 
 #include "Log.hpp"
+#include "resources/PackArchive.hpp"
 #include "resources/Resource.hpp"
+#include "resources/ResourceData.hpp"
+#include "resources/ResourceHandle.hpp"
+#include "resources/TextureAtlas.hpp"
 #include "services/Services.hpp"
 
 namespace Cleave {
@@ -13,52 +17,129 @@ class Renderer;
 #define GET_RESMGR() Services::Get<ResourceManager>()
 class ResourceManager : public Service {
 public:
+    // What a scan records about a file; a lazy scan records nothing else
+    struct ManifestEntry {
+        std::string path;
+        ResourceLoader* loader = nullptr;
+        std::string_view type;
+        uintmax_t size = 0;
+        std::filesystem::file_time_type modified;
+    };
+
     void RegisterLoader(std::unique_ptr<ResourceLoader> loader);
 
     static const char* GetTypeName() { return "cleave::ResourceManager"; }
 
+    // Loads a resource the first time it's asked for when scanned lazily, which makes Get a
+    // context thread call. Property setters defer theirs with SceneLoad::RunOnMainThread.
     template <typename T>
     requires std::derived_from<T, Resource>
     std::shared_ptr<T> Get(const std::string& name) {
-        auto it = m_resources.find(name);
-        if (it != m_resources.end()) {
-            return std::dynamic_pointer_cast<T>(it->second);
+        uint32_t slot;
+        if (Acquire(name, slot)) {
+            return std::dynamic_pointer_cast<T>(m_slots[slot].resource);
         }
         LOG_ERROR("Resource not found: " << name);
         return nullptr;
     }
 
+    // Resolves `name` once, loading it like Get does. Hold on to the handle instead of
+    // calling Get on hot paths; an invalid handle is returned if the type doesn't match.
+    template <typename T>
+    requires std::derived_from<T, Resource>
+    ResourceHandle<T> GetHandle(const std::string& name) {
+        uint32_t slot;
+        if (!Acquire(name, slot)) {
+            LOG_ERROR("Resource not found: " << name);
+            return {};
+        }
+        if (!dynamic_cast<T*>(m_slots[slot].resource.get())) {
+            LOG_ERROR("Resource " << name << " is a " << m_slots[slot].resource->GetTypeName() << ", not the requested type");
+            return {};
+        }
+        return {&m_slots, slot, m_slots[slot].generation};
+    }
+
+    // Answers from the manifest, so nothing gets loaded. False if `name` is another type.
     template <typename T>
     requires std::derived_from<T, Resource>
     bool Exists(const std::string& name) {
-        auto it = m_resources.find(name);
-        if (it != m_resources.end()) {
-            return true;
+        auto slot = m_slotIndices.find(name);
+        if (slot != m_slotIndices.end() && m_slots[slot->second].resource) {
+            return dynamic_cast<T*>(m_slots[slot->second].resource.get()) != nullptr;
         }
-        return false;
+        auto entry = m_manifest.find(name);
+        return entry != m_manifest.end() && entry->second.type == T::TYPE_NAME;
     }
 
+    // Only sees loaded resources; scan eagerly where everything has to be listed
     template <typename T>
     requires std::derived_from<T, Resource>
     std::vector<std::shared_ptr<T>> GetAll() {
         std::vector<std::shared_ptr<T>> result;
-        for (auto& [name, res] : m_resources) {
-            if (auto casted = std::dynamic_pointer_cast<T>(res)) {
+        for (uint32_t i = 0; i < m_slots.GetSize(); i++) {
+            if (auto casted = std::dynamic_pointer_cast<T>(m_slots[i].resource)) {
                 result.push_back(casted);
             }
         }
         return result;
     }
 
+    bool IsLoaded(const std::string& name) const;
+    // Drops the manager's reference and invalidates its handles. It stays in the manifest, so
+    // the next Get loads it again.
+    void Unload(const std::string& name);
+
+    // Once mounted, scans list the archive instead of the directory and reads are served from it.
+    // Names the archive doesn't have still fall back to loose files.
+    bool MountArchive(const std::string& path);
+    bool HasArchive() const;
+
+    // The bytes of a resource file, from the mounted archive or the disk. Safe to call from any thread.
+    bool ReadResource(const std::string& path, ResourceData& data) const;
+    // Archived files all share the archive's time. False if the file exists in neither.
+    bool GetModifiedTime(const std::string& path, std::filesystem::file_time_type& time) const;
+
+    // Lazy scans only fill the manifest and leave loading to Get and Preload
+    bool IsLazyLoading() const;
+    void SetLazyLoading(bool lazy);
+
     void ScanResources(const std::string_view path = "res");
     void ReloadAll();
 
+    // Loads the named resources that aren't loaded yet in one batch, decoding on the job
+    // system, e.g. everything a scene uses before it's shown. Names missing from the manifest are skipped.
+    void Preload(const std::vector<std::string>& names);
+
+    const std::unordered_map<std::string, ManifestEntry>& GetManifest() const;
+
     Renderer* GetRenderer() const;
     void SetRenderer(Renderer* renderer);
+
+    TextureAtlas& GetTextureAtlas();
 private:
-    std::unordered_map<std::string, std::shared_ptr<Resource>> m_resources;
+    // Finds the slot holding `name`, loading it from the manifest if it isn't loaded
+    bool Acquire(const std::string& name, uint32_t& slot);
+    // Puts `resource` in the slot for `name`, invalidating handles to what was there
+    void Store(const std::string& name, std::shared_ptr<Resource> resource);
+    // Prepares the entries on the job system and completes them on this thread
+    void Load(const std::vector<const ManifestEntry*>& entries);
+    // A Load in progress. Acquire finishes the names it holds instead of loading them twice.
+    struct LoadBatch;
+    // Completes the batch's next prepared entry, waiting for one if needed. False once all are done.
+    bool CompleteNext(LoadBatch& batch);
+
+    // Every name keeps its slot once it has one; unloading only empties it
+    ResourceSlotTable m_slots;
+    std::unordered_map<std::string, uint32_t> m_slotIndices;
+    std::unordered_map<std::string, ManifestEntry> m_manifest;
+    PackArchive m_archive;
+    std::filesystem::file_time_type m_archiveModified;
+    bool m_lazyLoading = false;
     std::vector<std::unique_ptr<ResourceLoader>> m_loaders;
     Renderer* m_renderer;
+    TextureAtlas m_textureAtlas;
+    LoadBatch* m_loadBatch = nullptr;  // Innermost, when completions load more
 };
 
 }  // namespace Cleave
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "services/SceneManager.hpp"
+
+#include "scene/Scene.hpp"
+#include "scene/SceneLoad.hpp"
+#include "profiling/Profiler.hpp"
+#include "Log.hpp"
+
+namespace Cleave {
+Scene* SceneManager::GetScene() const { return m_scene.get(); }
+std::shared_ptr<Scene> SceneManager::GetSharedScene() const { return m_scene; }
+
+void SceneManager::SetScene(std::shared_ptr<Scene> scene) {
+    m_pending.reset();
+    Adopt(std::move(scene));
+}
+
+std::shared_ptr<SceneLoad> SceneManager::SwitchTo(const std::string& path) {
+    m_pending = SceneLoader::LoadAsync(path);
+    return m_pending;
+}
+
+bool SceneManager::IsSwitching() const { return m_pending != nullptr; }
+
+void SceneManager::SetParallelTickEnabled(bool enabled) {
+    m_parallelTick = enabled;
+    if (m_scene) {
+        m_scene->SetParallelTickEnabled(enabled);
+    }
+}
+
+void SceneManager::Update() {
+    if (!m_pending || !m_pending->IsReady()) return;
+
+    CLEAVE_PROFILE_SCOPE("SceneManager::Update");
+    std::shared_ptr<SceneLoad> load = std::move(m_pending);
+    std::shared_ptr<Scene> scene = load->TakeScene();
+    if (!scene || !scene->GetRoot()) {
+        LOG_ERROR("Failed to switch to scene: " << load->GetPath());
+        return;
+    }
+    Adopt(std::move(scene));
+    LOG_INFO("Switched to scene: " << load->GetPath());
+}
+
+void SceneManager::Adopt(std::shared_ptr<Scene> scene) {
+    m_scene = std::move(scene);
+    if (m_scene) {
+        m_scene->SetParallelTickEnabled(m_parallelTick);
+    }
+}
+}  // namespace Cleave
@@ -0,0 +1,42 @@
+#pragma once
+#include <memory>
+#include <string>
+
+#include "services/Service.hpp"
+
+namespace Cleave {
+#define GET_SCENEMGR() Services::Get<SceneManager>()
+class Scene;
+class SceneLoad;
+
+// Owns the running scene. Level switches load on a background thread and the finished scene is
+// swapped in by Update, which the game loop calls between two frames.
+class SceneManager : public Service {
+public:
+    static const char* GetTypeName() { return "cleave::SceneManager"; }
+
+    Scene* GetScene() const;
+    std::shared_ptr<Scene> GetSharedScene() const;
+    // Swaps right away, dropping any switch that's still loading
+    void SetScene(std::shared_ptr<Scene> scene);
+
+    // Starts loading `path`. The current scene keeps running until Update swaps the new one in.
+    // Replacing a switch that's still loading waits for it to finish first.
+    std::shared_ptr<SceneLoad> SwitchTo(const std::string& path);
+    bool IsSwitching() const;
+
+    // Applied to the current scene and every scene swapped in after it
+    void SetParallelTickEnabled(bool enabled);
+
+    // Main thread only, between frames. Swaps in a finished switch; a failed one keeps the
+    // current scene.
+    void Update();
+
+private:
+    void Adopt(std::shared_ptr<Scene> scene);
+
+    std::shared_ptr<Scene> m_scene;
+    std::shared_ptr<SceneLoad> m_pending;
+    bool m_parallelTick = false;
+};
+}  // namespace Cleave
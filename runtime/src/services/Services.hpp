@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <stdexcept>
 #include "Log.hpp"
@@ -9,8 +10,15 @@
 namespace Cleave {
 class Services {
 private:
-    static std::unordered_map<std::string, std::shared_ptr<void>>& GetServices() {
-        static std::unordered_map<std::string, std::shared_ptr<void>> services;
+    // Lets lookups hash the type name in place instead of building a std::string each time
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(const std::string_view name) const { return std::hash<std::string_view>()(name); }
+    };
+    using ServiceMap = std::unordered_map<std::string, std::shared_ptr<void>, NameHash, std::equal_to<>>;
+
+    static ServiceMap& GetServices() {
+        static ServiceMap services;
         return services;
     }
 
@@ -31,10 +39,10 @@ public:
     requires std::derived_from<T, Service>
     static T* Get() {
         auto& services = GetServices();
-        std::string typeName = T::GetTypeName();
+        const std::string_view typeName = T::GetTypeName();
         auto it = services.find(typeName);
         if (it == services.end()) {
-            std::string error = "Service '" + typeName + "' not found";
+            std::string error = "Service '" + std::string(typeName) + "' not found";
             LOG_ERROR(error);
             throw std::runtime_error(error);
         }
@@ -45,10 +53,10 @@ public:
     requires std::derived_from<T, Service>
     static std::shared_ptr<T> GetShared() {
         auto& services = GetServices();
-        std::string typeName = T::GetTypeName();
+        const std::string_view typeName = T::GetTypeName();
         auto it = services.find(typeName);
         if (it == services.end()) {
-            std::string error = "Service '" + typeName + "' not found";
+            std::string error = "Service '" + std::string(typeName) + "' not found";
             LOG_ERROR(error);
             throw std::runtime_error(error);
         }
@@ -58,15 +66,13 @@ public:
     template <typename T>
     requires std::derived_from<T, Service>
     static bool IsProvided() {
-        std::string typeName = T::GetTypeName();
-        return GetServices().find(typeName) != GetServices().end();
+        return GetServices().contains(std::string_view(T::GetTypeName()));
     }
 
     template <typename T>
     requires std::derived_from<T, Service>
     static void Remove() {
-        std::string typeName = T::GetTypeName();
-        GetServices().erase(typeName);
+        GetServices().erase(std::string(T::GetTypeName()));
     }
 
     static void Clear() { GetServices().clear(); }
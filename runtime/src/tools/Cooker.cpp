@@ -0,0 +1,62 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include "Log.hpp"
+#include "resources/CookedTexture.hpp"
+#include "resources/Texture.hpp"
+#include "thirdparty/stb_image.h"
+
+using namespace Cleave;
+
+// Usage: CleaveCooker <resource directory> [--mipmaps]
+// Writes a .ctex next to every image older than it, e.g. "res/textures/cat.png.ctex".
+// Mipmapped textures can't join the atlas, so only ask for them when drawing scaled down.
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3 || (argc == 3 && std::strcmp(argv[2], "--mipmaps") != 0)) {
+        LOG_ERROR("Usage: CleaveCooker <resource directory> [--mipmaps]");
+        return 1;
+    }
+    const std::filesystem::path resourceDir = argv[1];
+    const bool mipmaps = argc == 3;
+    if (!std::filesystem::is_directory(resourceDir)) {
+        LOG_ERROR("Not a directory: " << resourceDir.string());
+        return 1;
+    }
+
+    int cooked = 0, upToDate = 0, failed = 0;
+    for (const auto& file : std::filesystem::recursive_directory_iterator(resourceDir)) {
+        if (!file.is_regular_file() || !TextureLoader::IsImageExtension(file.path().extension().string())) continue;
+
+        std::filesystem::path cookedPath = file.path();
+        cookedPath += CookedTexture::EXTENSION;
+        std::error_code error;
+        const auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+        if (!error && cookedTime >= file.last_write_time()) {
+            upToDate++;
+            continue;
+        }
+
+        int width = 0, height = 0, channels = 0;
+        std::unique_ptr<unsigned char, decltype(&stbi_image_free)> pixels(
+            stbi_load(file.path().string().c_str(), &width, &height, &channels, STBI_rgb_alpha), stbi_image_free);
+        if (!pixels) {
+            LOG_ERROR("Failed to load texture from file: " << file.path().string());
+            failed++;
+            continue;
+        }
+
+        const std::vector<uint8_t> data = TextureCooker::Cook(pixels.get(), width, height, mipmaps);
+        std::ofstream out(cookedPath, std::ios::binary);
+        if (!out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+            LOG_ERROR("Failed to write: " << cookedPath.string());
+            failed++;
+            continue;
+        }
+        cooked++;
+    }
+
+    LOG_INFO("Cooked " << cooked << " textures, " << upToDate << " up to date, " << failed << " failed");
+    return failed == 0 ? 0 : 1;
+}
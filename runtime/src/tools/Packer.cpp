@@ -0,0 +1,47 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "Log.hpp"
+#include "resources/PackArchive.hpp"
+
+using namespace Cleave;
+
+// Usage: CleavePacker <resource directory> <output .pak>
+// Entries are named the way the runtime scans them, e.g. "res/sprites/player.png"
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        LOG_ERROR("Usage: CleavePacker <resource directory> <output .pak>");
+        return 1;
+    }
+
+    const std::filesystem::path resourceDir = std::filesystem::path(argv[1]).lexically_normal();
+    if (!std::filesystem::is_directory(resourceDir)) {
+        LOG_ERROR("Not a directory: " << resourceDir.string());
+        return 1;
+    }
+    // A trailing separator leaves an empty filename after normalizing
+    const std::filesystem::path root = resourceDir.has_filename() ? resourceDir.filename() : resourceDir.parent_path().filename();
+
+    PackWriter writer;
+    for (const auto& file : std::filesystem::recursive_directory_iterator(resourceDir)) {
+        if (!file.is_regular_file()) continue;
+
+        std::ifstream stream(file.path(), std::ios::binary);
+        if (!stream.is_open()) {
+            LOG_ERROR("Failed to open: " << file.path().string());
+            return 1;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        writer.Add((root / std::filesystem::relative(file.path(), resourceDir)).generic_string(), std::move(data));
+    }
+
+    if (!writer.Write(argv[2])) {
+        LOG_ERROR("Failed to write: " << argv[2]);
+        return 1;
+    }
+    LOG_INFO("Packed " << writer.GetEntryCount() << " files, " << writer.GetSize() << " bytes stored as "
+                       << writer.GetStoredSize() << " bytes, into " << argv[2]);
+    return 0;
+}